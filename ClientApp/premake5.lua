@@ -42,6 +42,10 @@ project "ClientApp"
 		{
 			"CL_Platform_Linux"
 		}
+		links
+		{
+			"pthread",
+		}
 	filter "system:macosx"
 		defines
 		{
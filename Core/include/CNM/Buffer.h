@@ -13,12 +13,15 @@ static inline void SpinPause() {}
 #endif
 
 #include <CNM/macros.h>
+#include <CNM/cnm_core.h>
 #include <CNM/WireFormat.h>
 
 #include <new>
 #include <atomic>
+#include <mutex>
 #include <cstdint>
 #include <vector>
+#include <array>
 #include <span>
 
 namespace Carnival {
@@ -249,6 +252,102 @@ namespace Carnival {
 	};
 
 
+	// Receive Slab :
+	// One allocation of fixed-size slots, each starting on its own cache line.
+	// A batched receive fills slots with datagram, length and sender; handlers read
+	// them through non-owning views until the next batch overwrites them.
+	class ReceiveSlab {
+	public:
+		static constexpr uint64_t SLOT_ALIGN{ std::hardware_destructive_interference_size };
+
+		ReceiveSlab(uint32_t slotCount, uint32_t slotSize = Network::PACKET_MTU)
+			: m_Stride{ (slotSize + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1) } {
+			CL_CORE_ASSERT(slotCount != 0 && slotSize != 0, "slab must have slots");
+			m_Data = new (std::align_val_t{ SLOT_ALIGN }) std::byte[m_Stride * slotCount];
+			m_Slots.resize(slotCount);
+			for (uint32_t i{}; i < slotCount; i++) {
+				m_Slots[i].data = m_Data + m_Stride * i;
+				m_Slots[i].capacity = slotSize;
+			}
+		}
+		~ReceiveSlab() noexcept { ::operator delete[](m_Data, std::align_val_t{ SLOT_ALIGN }); }
+
+		ReceiveSlab(const ReceiveSlab&) = delete;
+		ReceiveSlab& operator=(const ReceiveSlab&) = delete;
+		ReceiveSlab(ReceiveSlab&&) = delete;
+		ReceiveSlab& operator=(ReceiveSlab&&) = delete;
+
+		// Every slot, handed to Socket::receiveBatch
+		std::span<Network::ReceiveSlot> slots() noexcept { return m_Slots; }
+		// View of one filled slot
+		static std::span<const std::byte> view(const Network::ReceiveSlot& slot) noexcept {
+			return { slot.data, slot.size };
+		}
+		uint32_t capacity() const noexcept { return static_cast<uint32_t>(m_Slots.size()); }
+		// Whole backing allocation
+		std::span<const std::byte> memory() const noexcept { return { m_Data, m_Stride * m_Slots.size() }; }
+	private:
+		std::byte* m_Data{ nullptr };
+		uint64_t m_Stride{};
+		std::vector<Network::ReceiveSlot> m_Slots;
+	};
+
+	// Datagrams received by one worker for a session another worker owns.
+	// Producers copy in under the lock, the owner swaps sides and reads without it.
+	class HandoffQueue {
+	public:
+		HandoffQueue() = default;
+		HandoffQueue(const HandoffQueue&) = delete;
+		HandoffQueue& operator=(const HandoffQueue&) = delete;
+		HandoffQueue(HandoffQueue&&) = delete;
+		HandoffQueue& operator=(HandoffQueue&&) = delete;
+
+		void push(uint8_t socket, std::span<const std::byte> data, const Network::PacketInfo& info) {
+			std::lock_guard lock{ m_Lock };
+			auto& side{ m_Sides[m_Write] };
+			side.entries.emplace_back(static_cast<uint32_t>(side.bytes.size()),
+				static_cast<uint32_t>(data.size()), socket, info);
+			side.bytes.insert(side.bytes.end(), data.begin(), data.end());
+			m_Pending.store(true, std::memory_order_release);
+		}
+
+		// Calls fn(socket, data, info) for every queued datagram, owner thread only
+		template<typename Fn>
+		void drain(Fn&& fn) {
+			if (!m_Pending.load(std::memory_order_acquire)) return;
+			uint8_t read{};
+			{
+				std::lock_guard lock{ m_Lock };
+				read = m_Write;
+				m_Write ^= 1;
+				m_Pending.store(false, std::memory_order_relaxed);
+			}
+			auto& side{ m_Sides[read] };
+			for (const auto& entry : side.entries) {
+				fn(entry.socket, std::span<const std::byte>{ side.bytes.data() + entry.offset, entry.size },
+					entry.info);
+			}
+			side.entries.clear();
+			side.bytes.clear();
+		}
+	private:
+		struct Entry {
+			uint32_t offset;
+			uint32_t size;
+			uint8_t socket;
+			Network::PacketInfo info;
+		};
+		struct Side {
+			std::vector<Entry> entries;
+			std::vector<std::byte> bytes;
+		};
+
+		std::mutex m_Lock;
+		std::array<Side, 2> m_Sides;
+		uint8_t m_Write{};
+		std::atomic<bool> m_Pending{ false };
+	};
+
 	/*
 	* TODO: Reliable Resend Buffer
 	* 
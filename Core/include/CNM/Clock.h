@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#ifdef CL_X64
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#else
+		#include <x86intrin.h>
+	#endif
+#endif
+
+//CNM
+#include <CNM/macros.h>
+#include <CNM/utils.h>
+
+namespace Carnival::Engine {
+
+	/*
+	*  Invariant TSC read with rdtscp, calibrated once against steady_clock.
+	*  ticks() and toNanos() time spans far below a microsecond for profiling. now() maps onto the
+	*  getTime timeline so it can serve as a TimeSource, the two drift apart by the calibration
+	*  error so a consumer should stick to one. Calibrate before starting the threads that read it.
+	*/
+	class TscClock {
+	public:
+		// Measure the tick rate over windowUs, false without an invariant TSC
+		static bool calibrate(uint32_t windowUs = 50'000) noexcept;
+		static bool available() noexcept { return s_MicroMultiplier != 0; }
+
+		static uint64_t ticks() noexcept {
+#ifdef CL_X64
+			uint32_t aux{};
+			return __rdtscp(&aux);
+#else
+			return 0;
+#endif
+		}
+		static uint64_t toNanos(uint64_t ticks) noexcept { return scale(ticks, s_NanoMultiplier); }
+		static uint64_t toMicros(uint64_t ticks) noexcept { return scale(ticks, s_MicroMultiplier); }
+		// Microseconds on the getTime timeline, getTime itself until calibrated
+		static uint64_t now() noexcept {
+			if (!available()) return getTime();
+			return s_BaseMicros + toMicros(ticks() - s_BaseTicks);
+		}
+	private:
+		// ticks * multiplier / 2^32 without a 128-bit product
+		static uint64_t scale(uint64_t ticks, uint64_t multiplier) noexcept {
+			return (ticks >> 32) * multiplier + (((ticks & UINT32_MAX) * multiplier) >> 32);
+		}
+
+		inline static uint64_t s_MicroMultiplier{}; // microseconds per tick, 32.32 fixed point
+		inline static uint64_t s_NanoMultiplier{};
+		inline static uint64_t s_BaseTicks{};
+		inline static uint64_t s_BaseMicros{};
+	};
+	inline uint64_t getTscTime() noexcept { return TscClock::now(); }
+}
+
+namespace Carnival::Network {
+
+	// Protocol time, read at phase boundaries of a tick and shared by every packet handled in between
+	class TickClock {
+	public:
+		explicit TickClock(Engine::TimeSource source = &Engine::getTime) noexcept
+			: m_Source{ source ? source : &Engine::getTime }, m_Now{ m_Source() } {}
+
+		uint64_t now() const noexcept { return m_Now; }
+		// Read the source again, never stepping back if it is skewed across cores
+		uint64_t refresh() noexcept { return m_Now = std::max(m_Now, m_Source()); }
+	private:
+		Engine::TimeSource m_Source;
+		uint64_t m_Now{};
+	};
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//CNM
+#include <CNM/macros.h>
+#include <CNM/cnm_core.h>
+
+namespace Carnival::Network {
+
+	/*
+	*  Per-source admission ahead of header parsing: a token bucket per address, and a ban once an
+	*  address and port rack up dropThreshold malformed packets within a second. A spoofer has to guess
+	*  the port to shut out a client behind the same address; banPorts port bans within banDuration ban
+	*  the whole address, so a flood rotating its ports gets the same treatment.
+	*  Fixed size, 4-way set associative tables, a new entry evicts the longest idle one it collides
+	*  with so spoofed floods can't grow them. Times are wrapping 32-bit microseconds.
+	*/
+	class IngressFilter {
+	public:
+		static constexpr uint32_t WAYS{ 4 };
+		static constexpr uint32_t STRIKE_WINDOW{ 1'000'000 };
+
+		explicit IngressFilter(const IngressPolicy& policy) : m_Policy{ policy } {
+			if (!active()) return;
+			CL_CORE_ASSERT(m_Policy.banDuration < INT32_MAX, "Ban duration must fit wrapping microseconds");
+			const uint32_t sets{ std::bit_ceil(std::max<uint32_t>(m_Policy.sources / WAYS, 1)) };
+			m_Sources.resize(static_cast<size_t>(sets) * WAYS);
+			m_Offenders.resize(static_cast<size_t>(sets) * WAYS);
+			m_SetMask = sets - 1;
+		}
+
+		bool active() const noexcept { return m_Policy.sourceRate != 0; }
+
+		// Spend a token for this datagram, false if the address or port is banned or over its rate
+		bool admit(ipv4_addr addr, uint16_t port, uint32_t now) noexcept {
+			Source& source{ lookup(addr, now) };
+			if (source.banned) {
+				if (now - source.banStamp < m_Policy.banDuration) return false;
+				source.banned = false;
+				source.portBans = 0;
+			}
+			// Only addresses with a recent port ban pay for the second lookup
+			if (source.portBans) {
+				if (Offender* pOffender{ findOffender(addr, port) }; pOffender && pOffender->banned) {
+					if (now - pOffender->strikeStamp < m_Policy.banDuration) return false;
+					pOffender->banned = false;
+					pOffender->strikes = 0;
+				}
+			}
+			// Credit in thousandths of a packet
+			const uint64_t refill{ static_cast<uint64_t>(now - source.stamp) * m_Policy.sourceRate / 1'000 };
+			source.credit = static_cast<uint32_t>(std::min<uint64_t>(source.credit + refill,
+				static_cast<uint64_t>(m_Policy.sourceBurst) * 1'000));
+			source.stamp = now;
+			if (source.credit < 1'000) return false;
+			source.credit -= 1'000;
+			return true;
+		}
+		// Admitted datagram was malformed, true once enough of them ban the port or its address
+		bool strike(ipv4_addr addr, uint16_t port, uint32_t now) noexcept {
+			if (!m_Policy.dropThreshold) return false;
+			Source* pSource{ find(addr) };
+			if (!pSource || pSource->banned) return false;
+			Offender& offender{ lookupOffender(addr, port, now) };
+			if (offender.banned) {
+				if (now - offender.strikeStamp < m_Policy.banDuration) return false;
+				offender.banned = false;
+				offender.strikes = 0;
+				offender.strikeStamp = now;
+			}
+			if (now - offender.strikeStamp > STRIKE_WINDOW) {
+				offender.strikes = 0;
+				offender.strikeStamp = now;
+			}
+			if (++offender.strikes < m_Policy.dropThreshold) return false;
+			offender.banned = true;
+			offender.strikeStamp = now;
+
+			// Port bans count toward the address within one ban duration
+			if (!pSource->portBans || now - pSource->banStamp >= m_Policy.banDuration) {
+				pSource->portBans = 0;
+				pSource->banStamp = now;
+			}
+			if (++pSource->portBans >= m_Policy.banPorts) {
+				pSource->banned = true;
+				pSource->banStamp = now;
+			}
+			return true;
+		}
+	private:
+		struct Source {
+			ipv4_addr addr{};
+			uint32_t credit{}; // thousandths of a packet
+			uint32_t stamp{}; // last refill
+			uint32_t banStamp{}; // ban start while banned, else the first of its recent port bans
+			uint16_t portBans{};
+			bool used{ false };
+			bool banned{ false };
+		};
+		// Strikes and the ban of one address and port
+		struct Offender {
+			ipv4_addr addr{};
+			uint32_t strikeStamp{}; // strike window start, ban start while banned
+			uint16_t port{};
+			uint16_t strikes{};
+			bool used{ false };
+			bool banned{ false };
+		};
+
+		Source* set(ipv4_addr addr) noexcept {
+			const uint32_t index{ ((addr.addr32 * 0x9E3779B1u) >> 16) & m_SetMask };
+			return &m_Sources[static_cast<size_t>(index) * WAYS];
+		}
+		Offender* offenderSet(ipv4_addr addr, uint16_t port) noexcept {
+			const uint32_t index{ (((addr.addr32 ^ (static_cast<uint32_t>(port) << 16)) * 0x9E3779B1u) >> 16) & m_SetMask };
+			return &m_Offenders[static_cast<size_t>(index) * WAYS];
+		}
+		Source* find(ipv4_addr addr) noexcept {
+			Source* pSet{ set(addr) };
+			for (uint32_t way{}; way < WAYS; way++)
+				if (pSet[way].used && pSet[way].addr == addr) return &pSet[way];
+			return nullptr;
+		}
+		Offender* findOffender(ipv4_addr addr, uint16_t port) noexcept {
+			Offender* pSet{ offenderSet(addr, port) };
+			for (uint32_t way{}; way < WAYS; way++)
+				if (pSet[way].used && pSet[way].addr == addr && pSet[way].port == port) return &pSet[way];
+			return nullptr;
+		}
+		Source& lookup(ipv4_addr addr, uint32_t now) noexcept {
+			Source* pSet{ set(addr) };
+			Source* pVictim{ nullptr };
+			for (uint32_t way{}; way < WAYS; way++) {
+				Source& source{ pSet[way] };
+				if (source.used && source.addr == addr) return source;
+				// Free way, else the longest idle one, bans are kept while others are available
+				auto idle = [&](const Source& s) {
+					return !s.used ? UINT64_MAX : (s.banned ? 0 : 1ull << 32) + (now - s.stamp);
+				};
+				if (!pVictim || idle(source) > idle(*pVictim)) pVictim = &source;
+			}
+			*pVictim = Source{ .addr = addr, .credit = m_Policy.sourceBurst * 1'000u, .stamp = now, .used = true };
+			return *pVictim;
+		}
+		Offender& lookupOffender(ipv4_addr addr, uint16_t port, uint32_t now) noexcept {
+			Offender* pSet{ offenderSet(addr, port) };
+			Offender* pVictim{ nullptr };
+			for (uint32_t way{}; way < WAYS; way++) {
+				Offender& offender{ pSet[way] };
+				if (offender.used && offender.addr == addr && offender.port == port) return offender;
+				// Same preference as sources, by the last strike
+				auto idle = [&](const Offender& o) {
+					return !o.used ? UINT64_MAX : (o.banned ? 0 : 1ull << 32) + (now - o.strikeStamp);
+				};
+				if (!pVictim || idle(offender) > idle(*pVictim)) pVictim = &offender;
+			}
+			*pVictim = Offender{ .addr = addr, .strikeStamp = now, .port = port, .used = true };
+			return *pVictim;
+		}
+
+		std::vector<Source> m_Sources;
+		std::vector<Offender> m_Offenders;
+		IngressPolicy m_Policy;
+		uint32_t m_SetMask{};
+	};
+}
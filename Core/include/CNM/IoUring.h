@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <span>
+
+//CNM
+#include <CNM/cnm_core.h>
+
+namespace Carnival::Network {
+
+	// Datagram reaped from the receive ring, data is owned by the ring until released
+	struct RingPacket {
+		std::span<const std::byte>	data{};
+		PacketInfo					info{};
+		uint16_t					bufferID{};
+		uint8_t						socketIndex{};
+	};
+
+	// Sends that completed with an error, worst is the most severe of them
+	struct SendFailures {
+		uint32_t	count{};
+		SocketError	worst{ SocketError::None };
+	};
+
+	// io_uring transport: multishot recvmsg into a registered buffer ring,
+	// sendmsg batched into one submission per tick. Linux only, inactive elsewhere.
+	class IoUring {
+	public:
+		IoUring() noexcept;
+		~IoUring() noexcept;
+
+		IoUring(const IoUring&)				= delete;
+		IoUring& operator=(const IoUring&)	= delete;
+		IoUring(IoUring&&)					= delete;
+		IoUring& operator=(IoUring&&)		= delete;
+
+		// Create the ring and arm a multishot receive per socket handle, false if the kernel lacks support
+		// gro sizes receive buffers for coalesced datagrams and reports their segment size
+		bool init(std::span<const uint64_t> handles, bool gro = false) noexcept;
+		void shutdown() noexcept;
+		bool isActive() const noexcept { return m_Ring != nullptr; }
+
+		// Copy datagram into a send slot, goes out on the next submit()
+		bool queueSend(uint8_t socketIndex, const void* pData, uint64_t size,
+			ipv4_addr addr, uint16_t port) noexcept;
+		// Submit queued work and flush pending completions, single syscall
+		bool submit() noexcept;
+		// Pop next received datagram, send and re-arm completions are handled internally
+		bool nextPacket(RingPacket& packet) noexcept;
+		// Send failures reaped by nextPacket since the last call
+		SendFailures takeSendFailures() noexcept;
+		// Return a packet's buffer to the kernel
+		void release(const RingPacket& packet) noexcept;
+
+		// Pollable ring descriptor, readable while completions are pending
+		uint64_t getHandle() const noexcept;
+		// mlock receive buffers and send slots, false if inactive or refused
+		bool lockBuffers() noexcept;
+	private:
+		struct Ring;
+		std::unique_ptr<Ring> m_Ring;
+	};
+}
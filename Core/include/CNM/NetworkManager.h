@@ -3,11 +3,19 @@
 #include <string_view>
 #include <array>
 #include <vector>
-#include <deque>
+#include <queue>
+#include <mutex>
 // CNM
 #include <CNM/cnm_core.h>
 #include <CNM/utils.h>
 #include <CNM/Socket.h>
+#include <CNM/IoUring.h>
+#include <CNM/SessionTable.h>
+#include <CNM/IngressFilter.h>
+#include <CNM/TimerWheel.h>
+#include <CNM/Clock.h>
+#include <CNM/Buffer.h>
+#include <CNM/ThreadConfig.h>
 #include <CNM/Replication.h>
 
 namespace Carnival::ECS {
@@ -15,12 +23,14 @@ namespace Carnival::ECS {
 }
 
 namespace Carnival::Network {
+	class NetworkWorkerPool;
+
 	class NetworkManager {
 	public:
 		// Hooks into world, Sets up sockets
 		NetworkManager(ECS::World* pWorld, 
 			const SocketData& relSockData, const SocketData& urelSockData, 
-			uint16_t maxSessions);
+			uint16_t maxSessions, const NetworkConfig& config = {});
 		~NetworkManager() = default;
 
 		NetworkManager(const NetworkManager&)				= delete;
@@ -29,92 +39,205 @@ namespace Carnival::Network {
 		NetworkManager& operator=(NetworkManager&&)			= delete;
 		
 		bool isRunning() { return m_Running.test(std::memory_order_acquire); }
-		// Main loop, drives network tick
-		void run(uint16_t tickRate); // Tickrate must be a power of two
+		// Main loop, drives network tick, applies threadConfig to the calling thread first
+		void run(uint16_t tickRate, const ThreadConfig& threadConfig = {}); // Tickrate must be a power of two
 		void stop(); // blocking
 
 		void attemptConnect(ipv4_addr addr, uint16_t port);
+
+		// Last published counters, safe from any thread
+		NetworkStats getStats();
+		// Which thread settings run() managed to apply, valid once isRunning()
+		ThreadConfigStatus getThreadStatus() const noexcept { return m_ThreadStatus; }
+		// Bound port of an endpoint socket, resolved if bound to port 0
+		uint16_t getPort(uint8_t endpoint) const noexcept { return m_Socks[endpoint].getPort(); }
 	private:
+		friend class NetworkWorkerPool;
+
 		inline bool sendReliable(ipv4_addr addr, uint16_t port) noexcept;
 		inline bool sendReliable(Endpoint& ep) noexcept;
 		inline bool sendUnreliable(ipv4_addr addr, uint16_t port) noexcept;
 		inline bool sendUnreliable(Endpoint& ep) noexcept;
 		inline bool sendReliablePayload(PacketDescriptor& packet) noexcept;
+		// Send queued payloads, one GSO super-datagram per session run when enabled
+		void sendPayloadBatch();
+		// Route datagram through the ring if active, socket otherwise
+		inline bool transmit(uint8_t socket, const void* pData, uint64_t size,
+			ipv4_addr addr, uint16_t port) noexcept;
 		// void sendSnapshot(ipv4_addr addr, uint16_t port);
 
 		void writeHeader(const HeaderInfo& header);
 		// returns bytes written
 		uint64_t writeHeader(void* pData, const HeaderInfo& header);
-		HeaderInfo parseHeader();
+		HeaderInfo parseHeader(std::span<const std::byte> packet);
+		// Arm the delayed ack, immediate when the peer needs to hear about a gap now
+		inline void scheduleAck(ChannelState& state, bool immediate, uint64_t now) noexcept;
+		// Ack state for an outgoing header, adds the wide extension only when 32 bits cannot cover it
+		void fillAcks(HeaderInfo& header, Session& sesh, uint8_t channel, bool forceWide = false) noexcept;
 		
-		// Validate sequence numbers, update ACK, NAT handling
+		// Validate sequence numbers, update ACK, NAT handling, clear acked resend slots
 		bool updateSessionStats(const PacketInfo packet, const HeaderInfo& header,
-			Endpoint& ep, ChannelState& state);
-
-		inline bool handleReliablePacket(const PacketInfo);
-		inline bool handleUnreliablePacket(const PacketInfo);
+			Session& sesh, uint8_t channel, uint8_t endpoint);
+
+		// Hand datagram to its channel handler, splitting GRO-coalesced receives
+		// and forwarding packets of sessions owned by another pool worker
+		void dispatchDatagram(uint8_t socket, std::span<const std::byte> data, const PacketInfo info);
+		// Parse once, demultiplex on the header's channel
+		PacketResult handlePacket(uint8_t socket, std::span<const std::byte> packet, const PacketInfo info);
+		void publishStats();
+		// mlock slab, send and ring buffers, and the payload pool including chunks it grows later
+		bool lockBuffers() noexcept;
+		inline bool handleReliablePacket(std::span<const std::byte> packet, const HeaderInfo&, const PacketInfo);
+		inline bool handleUnreliablePacket(std::span<const std::byte> packet, const HeaderInfo&, const PacketInfo);
+
+		// Open sockets, reliable first
+		std::span<const uint8_t> activeSockets() const noexcept {
+			static constexpr std::array<uint8_t, SOCKET_COUNT> order{ EP_RELIABLE, EP_UNRELIABLE };
+			return std::span{ order }.first(m_Config.singleSocket ? 1 : SOCKET_COUNT);
+		}
+		// Endpoint tracking a socket's peer, single-socket mode keeps only the reliable one
+		uint8_t endpointIndex(uint8_t endpoint) const noexcept {
+			return m_Config.singleSocket ? uint8_t{ EP_RELIABLE } : endpoint;
+		}
 
 		inline bool handleError();
 		inline bool handleError(Socket& sock);
 
-		inline void handleConnectionRequest(const PacketInfo, const HeaderInfo&);
+		inline void handleConnectionRequest(const PacketInfo, const HeaderInfo&, std::span<const std::byte> payload);
 		inline bool handleConnectionAccept(const PacketInfo, const HeaderInfo&);
-		inline bool handleConnectionReject(const PacketInfo, const HeaderInfo&);
+		inline bool handleConnectionReject(const PacketInfo, const HeaderInfo&, std::span<const std::byte> payload);
 		inline bool handleHeartbeat(const PacketInfo, const HeaderInfo&, uint8_t Channel, uint8_t endpoint) noexcept;
 		inline bool handlePayload(const PacketInfo, const HeaderInfo&,
-			const uint64_t payloadSize, uint8_t Channel, uint8_t endpoint);
+			std::span<const std::byte> payload, uint8_t Channel, uint8_t endpoint);
+		// FEC load then body, delivered on arrival, plus whatever its group can now rebuild
+		inline bool handleUnreliablePayload(const PacketInfo, const HeaderInfo&,
+			std::span<const std::byte> payload, uint8_t Channel, uint8_t endpoint);
+		// Fold a data or parity packet into its FEC group, delivers the data and any it lets the group rebuild
+		bool handleFec(FecState& fec, const FecLoad& load, uint8_t type, std::span<const std::byte> body);
+		// Framed message, through its ordered stream if it has one.
+		// An ordered one further ahead than the sender may run drops the session
+		inline bool handleFrame(uint32_t id, Session& sesh, uint8_t frameType, std::span<const std::byte> body);
+		// One delivered message, type unused until messages are routed to the world
+		inline bool handleMessage(uint8_t type, std::span<const std::byte> message);
+		// Place a fragment, the completed batch to deliver and release, null until then
+		FragmentAssembly* reassemble(Session& sesh, const FragmentLoad& fragment,
+			std::span<const std::byte> payload) noexcept;
 
 		uint32_t createSession(const PendingPeer& info);
-		bool createSession(const PendingPeer& info, uint32_t Key);
+		Session* createSession(const PendingPeer& info, uint32_t Key); // null on an ID collision
+
+		// Handshake in flight to addr:port, null if none
+		PendingPeer* findPending(ipv4_addr addr, uint16_t port) noexcept;
+		void erasePending(const PendingPeer& peer) noexcept; // swap-remove, invalidates other pointers
 
 		inline void acceptConnection(uint32_t sessionID) 
 		{
-			m_CommandBuffer.emplace_back(&(m_Sessions.at(sessionID)),
+			m_CommandBuffer.emplace_back(m_Sessions.handle(sessionID),
 				sessionID,
 				static_cast<PacketFlags>(PacketFlags::CONNECTION_ACCEPT | PacketFlags::RELIABLE));
 		}
 		inline void rejectConnection(ipv4_addr addr, uint16_t port)
 		{
 			m_CommandBuffer.emplace_back(addr, port,
-				static_cast<PacketFlags>(PacketFlags::CONNECTION_ACCEPT | PacketFlags::RELIABLE));
+				static_cast<PacketFlags>(PacketFlags::CONNECTION_REJECT | PacketFlags::RELIABLE));
 		}
 
 		void queueReliablePayload(uint32_t id, Session&);
+		// Frame into the session outbox, a full outbox is packed into a packet first.
+		// Messages on the same ordered stream are delivered in queue order.
+		// False if nothing was queued: the message exceeds a fragment batch, the stream is out of range,
+		// the stream has ORDERED_WINDOW messages awaiting acks, or the send queue is at maxQueued
+		bool queueMessage(uint32_t id, Session& sesh, PacketFlags type, std::span<const std::byte> message,
+			uint8_t stream = UNORDERED);
+		void flushMessages(uint32_t id, Session& sesh); // outbox into one reliable packet, kept while the queue is full
+		// Lowest sequence of the stream still in the outbox, queued or unacked, nextSend if none
+		uint16_t oldestUnacked(const Session& sesh, uint8_t stream) const noexcept;
+		// Frame too large for a packet, lead (prefix and ordering) then message split into a fragment batch.
+		// The caller checked it fits MAX_FRAGMENTS
+		void queueFragments(uint32_t id, Session& sesh, PacketFlags type,
+			std::span<const std::byte> lead, std::span<const std::byte> message, const OrderedMarks& ordered);
+		// Into the session's send queue, numbered and sent once the window and pacing allow
+		void queueReliablePacket(uint32_t id, Session& sesh, PacketFlags flags, const FragmentLoad& fragment,
+			std::span<const std::byte> lead, std::span<const std::byte> payload, const OrderedMarks& ordered);
+		void queueUnreliablePayload(uint32_t id, Session& sesh);
+		// One unreliable packet, followed by the group's parity when it completes an FEC group
+		void sendUnreliablePayload(uint32_t id, Session& sesh, uint8_t channel, PacketFlags type,
+			std::span<const std::byte> body);
+		void sendBacklog(uint64_t now); // every session with queued packets, sets m_NextPace
+		void sendQueued(uint32_t id, Session& sesh, uint64_t now);
+		void flushSends(); // segmentation batch and ring submission
 
 		inline void sendRequest(ipv4_addr addr, uint16_t port) noexcept;
 		inline void sendAccept(uint32_t sessionID, Session& sesh) noexcept;
 		inline void sendReject(ipv4_addr addr, uint16_t port) noexcept;
+		// Reject carrying a cookie, sent straight from the receive path so a flood allocates nothing
+		inline void sendChallenge(ipv4_addr addr, uint16_t port) noexcept;
+		// Keyed hash of the address and a cookieLifetime time bucket
+		uint64_t makeCookie(ipv4_addr addr, uint16_t port, uint64_t bucket) const noexcept;
+		bool validCookie(ipv4_addr addr, uint16_t port, uint64_t cookie) const noexcept;
 
 		inline void sendHeartbeat(uint32_t sessionID, Session& sesh,
 			uint8_t endpointIndex, uint8_t channelIndex) noexcept;
+		// Ack-only, carries no sequence of its own
+		inline void sendAcknowledgement(uint32_t sessionID, Session& sesh) noexcept;
 
 		void collectIncoming(); // pull packets from sockets
-		void queueResends(); // Check Reliable Arena, resend if needed
-		void maintainSessions(); // retry pending, send heartbeat, check timeouts
-		void opportunisticReceive(); // Wait until next tick for new packets
+		void drainSockets(); // read until would-block, bounded by the tick budget
+		void queueResends(); // Pop due resend timers, resend if still unacked
+		void maintainSessions(); // fire due timers, queue payloads and delayed acks
+		// Act on a due timer or re-arm it if the session was active since
+		void handleTimer(const SessionTimer& timer, uint64_t now);
+		// Stop traffic and arm the grace timer that erases it, the session can't be resumed
+		void dropSession(uint32_t id, Session& sesh);
+		// Heartbeat and timeout timers for each endpoint in use
+		void scheduleSessionTimers(uint32_t id, const Session& sesh);
+		void opportunisticReceive(); // Block until the spin tail, handling packets as they land
 		void processCommands(); // send queued messages
 
-		// mark timed out sessions, remove after grace
-		void cleanupSessions();
+		void printSessions(); // debug status, small session counts only
 	private:
 		NetworkStats m_Stats{};
+		NetworkStats m_PublishedStats{};
+		std::mutex m_StatsLock;
 
 		std::array<Socket, SOCKET_COUNT> m_Socks; // 0 - High Frequency Unreliable, 1 - Reliable, Snapshots
-		std::vector<std::byte> m_PacketBuffer;
+		IoUring m_Ring;
+		ReceiveSlab m_RecvSlab;
+		IngressFilter m_Ingress;
+		std::vector<std::byte> m_SendBuffer; // outgoing control packets
 		std::vector<NetCommand> m_CommandBuffer;
-		std::deque<PacketDescriptor> m_ResendBuffer;
+		std::vector<PacketDescriptor*> m_PayloadBatch; // payloads deferred for segmentation offload
+		std::vector<std::byte> m_GSOBuffer;
+		bool m_GSOEnabled{ false };
+		// Min-heap of resend deadlines across sessions, stale entries skipped on pop
+		std::priority_queue<ResendTimer, std::vector<ResendTimer>, std::greater<>> m_ResendTimers;
+		TickClock m_Clock; // protocol time, refreshed per tick phase and receive batch
+		TimerWheel<SessionTimer> m_Timers; // heartbeats, timeouts, grace periods and handshake retries
+		std::vector<uint32_t> m_Backlogged; // sessions with a non-empty send queue
+		uint64_t m_NextPace{ UINT64_MAX }; // earliest pacing release among them
 
 		std::vector<PendingPeer> m_PendingConnections;
-		std::map<uint32_t, Session> m_Sessions;
+		FlatIndex<uint64_t> m_PendingIndex; // address key to position in m_PendingConnections
+		PacketPool m_PayloadPool; // outlives m_Sessions, their resend rings return slots to it
+		SessionTable m_Sessions;
 
 		ECS::World* m_pWorld;
 
 		uint64_t m_NextTick{ 0 };
+		uint32_t m_ReceiveBudget{}; // datagrams left this tick in drain mode
+		ThreadConfigStatus m_ThreadStatus{};
 
 		std::atomic_flag m_Running;
 		std::atomic_flag m_ShouldStop;
 
+		// Worker pool membership, null when running standalone
+		NetworkWorkerPool* m_pPool{ nullptr };
+		HandoffQueue m_Inbox;
+		uint16_t m_WorkerIndex{};
+
+		std::array<uint64_t, 2> m_CookieKey{}; // random per manager, outstanding cookies die with it
 		ReliabilityPolicy m_Policy{};
+		NetworkConfig m_Config{};
 		uint16_t m_MaxSessions{ 1 };
 	};
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+// STD
+#include <vector>
+#include <memory>
+#include <thread>
+// CNM
+#include <CNM/NetworkManager.h>
+
+namespace Carnival::Network {
+	/*
+	*  Server scale-out: one NetworkManager per worker thread, each with its own
+	*  SO_REUSEPORT socket pair on the shared ports. Sessions are sharded by ID,
+	*  a worker that receives another worker's packet hands it over.
+	*  Platforms without SO_REUSEPORT run a single worker.
+	*/
+	class NetworkWorkerPool {
+	public:
+		NetworkWorkerPool(ECS::World* pWorld,
+			const SocketData& relSockData, const SocketData& urelSockData,
+			uint16_t maxSessions, uint16_t workerCount, const NetworkConfig& config = {});
+		~NetworkWorkerPool();
+
+		NetworkWorkerPool(const NetworkWorkerPool&)				= delete;
+		NetworkWorkerPool& operator=(const NetworkWorkerPool&)	= delete;
+		NetworkWorkerPool(NetworkWorkerPool&&)					= delete;
+		NetworkWorkerPool& operator=(NetworkWorkerPool&&)		= delete;
+
+		// Launch one tick thread per worker, with enough CPUs in the mask each worker gets its own
+		void start(uint16_t tickRate, const ThreadConfig& threadConfig = {}); // Tickrate must be a power of two
+		void stop(); // blocking
+
+		// Merged counters of every worker, as of their last publish
+		NetworkStats getStats();
+		uint16_t workerCount() const noexcept { return static_cast<uint16_t>(m_Workers.size()); }
+		// Worker owning a session, stable for the pool's lifetime
+		uint16_t ownerOf(uint32_t sessionID) const noexcept {
+			// Fibonacci mix then range reduce, IDs are random but cheap to keep uniform
+			return static_cast<uint16_t>((static_cast<uint64_t>(sessionID * 0x9E3779B1u) * m_Workers.size()) >> 32);
+		}
+	private:
+		friend class NetworkManager;
+		void handOff(uint16_t owner, uint8_t socket, std::span<const std::byte> packet, const PacketInfo& info) {
+			m_Workers[owner]->m_Inbox.push(socket, packet, info);
+		}
+
+		std::vector<std::unique_ptr<NetworkManager>> m_Workers;
+		std::vector<std::jthread> m_Threads;
+	};
+}
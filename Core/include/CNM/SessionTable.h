@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//CNM
+#include <CNM/macros.h>
+#include <CNM/cnm_core.h>
+
+namespace Carnival::Network {
+
+	// Address and port packed into one index key
+	inline uint64_t addressKey(ipv4_addr addr, uint16_t port) noexcept {
+		return (static_cast<uint64_t>(addr.addr32) << 16) | port;
+	}
+
+	// Fibonacci mix, IDs are random but packed addresses are not
+	struct FibonacciMix {
+		template<typename Key>
+		uint32_t operator()(Key key) const noexcept {
+			return static_cast<uint32_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32);
+		}
+	};
+
+	// Open-addressing hash from a key to a slot index, linear probing, backward-shift erase so no tombstones.
+	// Keeps its load at or under one half, keys are session IDs or packed addresses
+	template<typename Key, typename Mix = FibonacciMix>
+	class FlatIndex {
+	public:
+		static constexpr uint32_t NONE{ UINT32_MAX };
+
+		explicit FlatIndex(uint32_t capacity = 16) { rehash(std::bit_ceil(std::max<uint32_t>(capacity, 16))); }
+
+		uint32_t find(Key key) const noexcept {
+			for (uint32_t i{ home(key) };; i = (i + 1) & m_Mask) {
+				const Entry& entry{ m_Entries[i] };
+				if (entry.slot == NONE) return NONE;
+				if (entry.key == key) return entry.slot;
+			}
+		}
+		// Map key to slot, replacing an existing mapping
+		void assign(Key key, uint32_t slot) {
+			if ((m_Count + 1) * 2 > m_Entries.size()) rehash(static_cast<uint32_t>(m_Entries.size() * 2));
+			for (uint32_t i{ home(key) };; i = (i + 1) & m_Mask) {
+				Entry& entry{ m_Entries[i] };
+				if (entry.slot == NONE) {
+					entry = { key, slot };
+					m_Count++;
+					return;
+				}
+				if (entry.key == key) {
+					entry.slot = slot;
+					return;
+				}
+			}
+		}
+		void erase(Key key) noexcept {
+			uint32_t hole{ home(key) };
+			for (;; hole = (hole + 1) & m_Mask) {
+				if (m_Entries[hole].slot == NONE) return;
+				if (m_Entries[hole].key == key) break;
+			}
+			// Pull later entries of the probe run back over the hole
+			for (uint32_t i{ (hole + 1) & m_Mask }; m_Entries[i].slot != NONE; i = (i + 1) & m_Mask) {
+				const uint32_t distance{ (i - home(m_Entries[i].key)) & m_Mask };
+				if (((i - hole) & m_Mask) > distance) continue; // home lies past the hole, stays put
+				m_Entries[hole] = m_Entries[i];
+				hole = i;
+			}
+			m_Entries[hole].slot = NONE;
+			m_Count--;
+		}
+		uint32_t size() const noexcept { return m_Count; }
+	private:
+		struct Entry {
+			Key key{};
+			uint32_t slot{ NONE };
+		};
+		uint32_t home(Key key) const noexcept { return Mix{}(key) & m_Mask; }
+		void rehash(uint32_t capacity) {
+			std::vector<Entry> old{ std::move(m_Entries) };
+			m_Entries.assign(capacity, Entry{});
+			m_Mask = capacity - 1;
+			m_Count = 0;
+			for (const auto& entry : old)
+				if (entry.slot != NONE) assign(entry.key, entry.slot);
+		}
+
+		std::vector<Entry> m_Entries;
+		uint32_t m_Mask{};
+		uint32_t m_Count{};
+	};
+
+	/*
+	*  Sessions in chunked slots that never move, found by ID or by their reliable endpoint's address.
+	*  Handles carry the slot's generation so a command queued for an erased session resolves to null.
+	*  Iteration walks a dense list of live slots.
+	*/
+	class SessionTable {
+	public:
+		explicit SessionTable(uint32_t expected = 0)
+			: m_ByID{ expected * 2 }, m_ByAddress{ expected * 2 } {}
+
+		SessionTable(const SessionTable&)				= delete;
+		SessionTable& operator=(const SessionTable&)	= delete;
+
+		Session* find(uint32_t id) noexcept {
+			const uint32_t index{ m_ByID.find(id) };
+			return index == FlatIndex<uint32_t>::NONE ? nullptr : &slot(index).session;
+		}
+		// Session whose reliable endpoint is addr:port
+		Session* find(ipv4_addr addr, uint16_t port, uint32_t* pID = nullptr) noexcept {
+			const uint32_t index{ m_ByAddress.find(addressKey(addr, port)) };
+			if (index == FlatIndex<uint64_t>::NONE) return nullptr;
+			if (pID) *pID = slot(index).id;
+			return &slot(index).session;
+		}
+		// Null once the session is erased, even if its slot was reused
+		Session* get(SessionHandle handle) noexcept {
+			if (handle.index >= m_SlotCount) return nullptr;
+			Slot& entry{ slot(handle.index) };
+			return (entry.live && entry.generation == handle.generation) ? &entry.session : nullptr;
+		}
+		SessionHandle handle(uint32_t id) const noexcept {
+			const uint32_t index{ m_ByID.find(id) };
+			if (index == FlatIndex<uint32_t>::NONE) return {};
+			return { index, slot(index).generation };
+		}
+
+		// Fresh session indexed under id and its reliable endpoint, null if the ID is taken
+		Session* emplace(uint32_t id, ipv4_addr addr, uint16_t port) {
+			if (m_ByID.find(id) != FlatIndex<uint32_t>::NONE) return nullptr;
+			if (m_Free.empty()) grow();
+			const uint32_t index{ m_Free.back() };
+			m_Free.pop_back();
+
+			Slot& entry{ slot(index) };
+			entry.id = id;
+			entry.live = true;
+			entry.livePosition = static_cast<uint32_t>(m_Live.size());
+			m_Live.push_back(index);
+			m_ByID.assign(id, index);
+			m_ByAddress.assign(addressKey(addr, port), index);
+			entry.session.endpoint[EP_RELIABLE].addr = addr;
+			entry.session.endpoint[EP_RELIABLE].port = port;
+			return &entry.session;
+		}
+		void erase(uint32_t id) {
+			const uint32_t index{ m_ByID.find(id) };
+			if (index == FlatIndex<uint32_t>::NONE) return;
+			Slot& entry{ slot(index) };
+			const auto& reliable{ entry.session.endpoint[EP_RELIABLE] };
+			const uint64_t key{ addressKey(reliable.addr, reliable.port) };
+			if (m_ByAddress.find(key) == index) m_ByAddress.erase(key);
+			m_ByID.erase(id);
+
+			// Swap-remove from the live list
+			const uint32_t last{ m_Live.back() };
+			m_Live[entry.livePosition] = last;
+			slot(last).livePosition = entry.livePosition;
+			m_Live.pop_back();
+
+			entry.session = Session{}; // returns pooled buffers now, not on reuse
+			entry.live = false;
+			entry.generation++;
+			m_Free.push_back(index);
+		}
+		// Reliable endpoint moved, keep the address index pointing at it
+		void rebind(uint32_t id, ipv4_addr oldAddr, uint16_t oldPort, ipv4_addr addr, uint16_t port) {
+			const uint32_t index{ m_ByID.find(id) };
+			if (index == FlatIndex<uint32_t>::NONE) return;
+			const uint64_t oldKey{ addressKey(oldAddr, oldPort) };
+			if (m_ByAddress.find(oldKey) == index) m_ByAddress.erase(oldKey);
+			m_ByAddress.assign(addressKey(addr, port), index);
+		}
+
+		// fn(id, session) over live sessions, fn may erase the session it is given
+		template<typename Fn>
+		void forEach(Fn&& fn) {
+			// Backwards, a swap-remove only pulls in a slot already visited
+			for (size_t i{ m_Live.size() }; i-- > 0;) {
+				Slot& entry{ slot(m_Live[i]) };
+				fn(entry.id, entry.session);
+			}
+		}
+		uint32_t size() const noexcept { return static_cast<uint32_t>(m_Live.size()); }
+		bool empty() const noexcept { return m_Live.empty(); }
+	private:
+		static constexpr uint32_t CHUNK_SLOTS{ 64 };
+		struct Slot {
+			Session session;
+			uint32_t id{};
+			uint32_t generation{};
+			uint32_t livePosition{};
+			bool live{ false };
+		};
+
+		Slot& slot(uint32_t index) noexcept { return m_Chunks[index / CHUNK_SLOTS][index % CHUNK_SLOTS]; }
+		const Slot& slot(uint32_t index) const noexcept { return m_Chunks[index / CHUNK_SLOTS][index % CHUNK_SLOTS]; }
+		// Chunks are never reallocated, session addresses stay valid for their lifetime
+		void grow() {
+			m_Chunks.push_back(std::make_unique<Slot[]>(CHUNK_SLOTS));
+			for (uint32_t i{ CHUNK_SLOTS }; i-- > 0;) m_Free.push_back(m_SlotCount + i);
+			m_SlotCount += CHUNK_SLOTS;
+		}
+
+		std::vector<std::unique_ptr<Slot[]>> m_Chunks;
+		std::vector<uint32_t> m_Free;
+		std::vector<uint32_t> m_Live; // slot indices, dense
+		FlatIndex<uint32_t> m_ByID;
+		FlatIndex<uint64_t> m_ByAddress;
+		uint32_t m_SlotCount{};
+	};
+}
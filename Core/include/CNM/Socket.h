@@ -16,6 +16,10 @@ namespace Carnival::Network {
 		~Socket() noexcept;
 		// Poll two sockets simultaneously
 		static PollResult waitForPackets(int32_t timeout, uint64_t handle1, uint64_t handle2) noexcept;
+		// One readiness check for up to SOCKET_COUNT handles, per-handle result, returns ready count
+		// timeout in microseconds, negative blocks, no handles just sleeps
+		static uint32_t pollSockets(std::span<const uint64_t> handles, std::span<PollResult> results,
+			int64_t timeoutUs = 0) noexcept;
 
 		//multiple sockets for same IP/Port not allowed
 		Socket(const Socket&)				= delete;
@@ -32,9 +36,16 @@ namespace Carnival::Network {
 		bool sendPacket(std::span<const std::byte> packet, const ipv4_addr outAddr, uint16_t port = 0) noexcept;
 		bool sendPacket(const void* pData, const uint64_t size,
 			const ipv4_addr out, const uint16_t port) noexcept;
+		// Send one GSO super-datagram, kernel splits it every segmentSize bytes (last may be shorter)
+		SocketError sendSegmented(const void* pData, const uint64_t size, uint16_t segmentSize,
+			const ipv4_addr out, const uint16_t port) noexcept;
 		PollResult poll() const noexcept;
 		// Receive One Datagram
 		PacketInfo receivePacket(std::vector<std::byte>& packet) noexcept;
+		// Receive up to slots.size() datagrams in as few syscalls as possible, returns count filled
+		uint32_t receiveBatch(std::span<ReceiveSlot> slots) noexcept;
+		// Send datagrams in as few syscalls as possible, returns count sent
+		uint32_t sendBatch(std::span<const SendSlot> packets) noexcept;
 		SocketError pollError() noexcept;
 
 		// Status Checking
@@ -42,11 +53,17 @@ namespace Carnival::Network {
 		bool isBound() const noexcept		{ return (m_Status & SocketStatus::BOUND); }
 		bool isError() const noexcept		{ return (m_Status & SocketStatus::SOCKERROR); }
 		bool isNonBlocking() const noexcept	{ return (m_Status & SocketStatus::NONBLOCKING); }
+		bool isGRO() const noexcept			{ return (m_Status & SocketStatus::GRO); }
+		bool isReusePort() const noexcept	{ return (m_Status & SocketStatus::REUSEPORT); }
 
 		// Set Address & Port, calls to these will cause a reset to the socket if bound
 		void setInAddress(const ipv4_addr inAddr);
 		void setPort(const uint16_t port);
 		void setNonBlocking(bool nb = true);
+		// Coalesced receives, cleared again on open if the platform refuses
+		void setGRO(bool gro = true);
+		// Share the port with other sockets of this process, cleared on open if unsupported
+		void setReusePort(bool reuse = true);
 
 		uint16_t getPort() const noexcept {
 			if (isBound()) return m_Port; 
@@ -66,8 +83,6 @@ namespace Carnival::Network {
 		ipv4_addr		m_InAddress{};
 		uint16_t		m_Port = 0;
 		SocketStatus	m_Status = SocketStatus::NONE;
-		char			m_Padding[1] = {0};
-		// 8-bit padding for alignment at the end
 	};
 
 }
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Carnival::Network {
+	// Placement and priority of a tick thread, applied by the thread to itself
+	struct ThreadConfig {
+		uint64_t	affinityMask{ 0 };	// bit per logical CPU, 0 leaves placement to the OS
+		bool		realtime{ false };	// SCHED_FIFO / time critical, usually needs privileges
+		int32_t		priority{ 10 };		// SCHED_FIFO priority when realtime
+		int32_t		nice{ 0 };			// niceness otherwise, negative needs privileges
+		bool		lockMemory{ false };	// keep network buffers resident
+	};
+
+	enum class SettingState : uint8_t {
+		NotRequested,
+		Applied,
+		Failed,
+	};
+	// Outcome of each ThreadConfig setting
+	struct ThreadConfigStatus {
+		SettingState affinity{ SettingState::NotRequested };
+		SettingState scheduling{ SettingState::NotRequested };
+		SettingState memoryLock{ SettingState::NotRequested };
+	};
+
+	// Apply affinity and scheduling to the calling thread, memory is locked by its owner
+	ThreadConfigStatus applyThreadConfig(const ThreadConfig& config) noexcept;
+	// Pin pages in RAM, released when the memory is unmapped or the process exits
+	bool lockMemory(const void* pData, uint64_t size) noexcept;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+//CNM
+#include <CNM/macros.h>
+
+namespace Carnival::Network {
+
+	/*
+	*  Hierarchical timing wheel, 4 levels of 64 slots at ~1ms resolution, about 4.7 hours of reach.
+	*  Scheduling is O(1), advancing costs the slots passed plus the timers due, never the timer count.
+	*  Later deadlines clamp to the outermost level and fire early, callers re-check and re-arm.
+	*/
+	template<typename T>
+	class TimerWheel {
+	public:
+		static constexpr uint32_t RESOLUTION_SHIFT{ 10 }; // 1024us per slot
+		static constexpr uint32_t SLOT_BITS{ 6 };
+		static constexpr uint32_t SLOTS{ 1u << SLOT_BITS };
+		static constexpr uint32_t LEVELS{ 4 };
+
+		explicit TimerWheel(uint64_t now = 0) : m_Current{ now >> RESOLUTION_SHIFT } {}
+
+		// Fires on the first advance at or past deadline, rounded up to the next slot
+		void schedule(uint64_t deadline, const T& value) {
+			place({ std::max<uint64_t>((deadline + (1ull << RESOLUTION_SHIFT) - 1) >> RESOLUTION_SHIFT, m_Current + 1), value });
+			m_Count++;
+		}
+		// fire(value) for every timer due by now, fire may schedule more
+		template<typename Fn>
+		void advance(uint64_t now, Fn&& fire) {
+			const uint64_t target{ now >> RESOLUTION_SHIFT };
+			while (m_Current < target) {
+				m_Current++;
+				// Entering a new lap of a level, pull its next slot down a level
+				for (uint32_t level{ 1 }; level < LEVELS; level++) {
+					if (m_Current & ((1ull << (SLOT_BITS * level)) - 1)) break;
+					auto& slot{ m_Slots[level][(m_Current >> (SLOT_BITS * level)) & (SLOTS - 1)] };
+					m_Firing.swap(slot);
+					for (const auto& entry : m_Firing) place(entry);
+					m_Firing.clear();
+				}
+				auto& slot{ m_Slots[0][m_Current & (SLOTS - 1)] };
+				if (slot.empty()) continue;
+				// Swapped out, a timer scheduled while firing lands in a later slot
+				m_Firing.swap(slot);
+				m_Count -= m_Firing.size();
+				for (const auto& entry : m_Firing) fire(entry.value);
+				m_Firing.clear();
+				// Hand the capacity back
+				if (slot.empty()) m_Firing.swap(slot);
+			}
+		}
+		size_t size() const noexcept { return m_Count; }
+	private:
+		struct Entry {
+			uint64_t tick{};
+			T value{};
+		};
+		void place(const Entry& entry) {
+			const uint64_t delta{ entry.tick - m_Current };
+			uint32_t level{};
+			while (level + 1 < LEVELS && delta >= (1ull << (SLOT_BITS * (level + 1)))) level++;
+			// Beyond the outermost lap, park in its furthest slot
+			const uint64_t tick{ level + 1 == LEVELS
+				? std::min<uint64_t>(entry.tick, m_Current + (1ull << (SLOT_BITS * LEVELS)) - 1) : entry.tick };
+			m_Slots[level][(tick >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back({ tick, entry.value });
+		}
+
+		std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> m_Slots;
+		std::vector<Entry> m_Firing;
+		uint64_t m_Current{}; // last slot advanced past
+		size_t m_Count{};
+	};
+}
@@ -1,17 +1,47 @@
 #pragma once
 
 #include <cstdint>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <memory>
+#include <span>
+#include <vector>
 #include <CNM/utils.h>
 
 namespace Carnival::Network {
 
 	// Maximum packet payload size chosen to avoid IP fragmentation on typical networks
 	constexpr static uint32_t PACKET_MTU{ 1200 };
+	// Largest coalesced receive the kernel can hand back with GRO enabled
+	constexpr static uint32_t GRO_MAX_SIZE{ 65535 };
+	// Largest UDP payload over IPv4, the cap for one segmented send
+	constexpr static uint32_t MAX_UDP_PAYLOAD{ 65507 };
 
 	// Protocol identifier hashed at compile time to reject incompatible clients
-	static constexpr uint32_t	HEADER_VERSION	= utils::fnv1a32("CarnivalEngine.Network_UDP_0.0.1");
+	static constexpr uint32_t	HEADER_VERSION	= utils::fnv1a32("CarnivalEngine.Network_UDP_0.6.0");
 	static constexpr uint8_t	CHANNELS		= 3; // Logical channels mapped to different reliability/ordering guarantees
 	static constexpr uint8_t	SOCKET_COUNT	= CHANNELS - 1; // 0 - High Frequency Unreliable, 1 - Reliable, Snapshots
+	static constexpr uint32_t	ACK_FIELD_BITS	= 32; // header ack field, every session
+	static constexpr uint32_t	WIDE_ACK_BITS	= 128; // ack field plus extension, sessions that negotiated WIDE_ACK
+	static constexpr uint32_t	RESEND_WINDOW	= WIDE_ACK_BITS; // reliable packets in flight per session
+	static constexpr uint32_t	HEADER_SIZE		= 21; // wire header without extensions
+	static constexpr uint32_t	MAX_HEADER_SIZE	= HEADER_SIZE + 12 + 6; // plus wide acks and fragment load
+	static constexpr uint32_t	FRAGMENT_PAYLOAD = PACKET_MTU - MAX_HEADER_SIZE; // every fragment but the last is full
+	static constexpr uint32_t	PACKET_PAYLOAD	= PACKET_MTU - HEADER_SIZE - 12; // unfragmented, room after a wide ack header
+	static constexpr uint32_t	MAX_FRAGMENTS	= ACK_FIELD_BITS; // per batch, fits the narrow ack window
+	static constexpr uint32_t	REASSEMBLY_SLOTS = 8; // fragment batches reassembled at once per session
+	static constexpr uint8_t	ORDERED_STREAMS	= 8; // independently ordered streams inside the reliable channel
+	static constexpr uint8_t	UNORDERED		= UINT8_MAX; // stream of a message with no ordering
+	static constexpr uint16_t	ORDERED_WINDOW	= 128; // messages a stream may run past its oldest unacked one
+	// Early ordered messages a session may hold. Packets leave in message order and a hole
+	// blocks sending past a resend window, so a well-behaved peer never gets past this
+	static constexpr uint32_t	MAX_HELD_BYTES	= RESEND_WINDOW * PACKET_PAYLOAD;
+	static constexpr uint8_t	MAX_FEC_DATA	= 24; // data packets per FEC group
+	static constexpr uint8_t	MAX_FEC_PARITY	= 8; // parity packets per FEC group, one bitmap covers both
 
 	// Logical packet channels
 	enum CH : uint8_t {
@@ -26,7 +56,7 @@ namespace Carnival::Network {
 	};
 
 	// current socket configuration and lifecycle state
-	enum SocketStatus : uint8_t {
+	enum SocketStatus : uint16_t {
 		NONE			= 0,		// uninitialized or closed
 		OPEN			= 1,		// handle created and valid
 		BOUND			= 1 << 1,	// bound to port/address
@@ -37,7 +67,9 @@ namespace Carnival::Network {
 		For Later Use
 		BROADCAST	= 1 << 5,
 		*/
+		GRO				= 1 << 6,	// receive coalesced datagrams (Linux UDP_GRO)
 		SOCKERROR		= 1 << 7,	// socket-level error
+		REUSEPORT		= 1 << 8,	// kernel load-balances one port across sockets (Linux SO_REUSEPORT)
 	};
 	union ipv4_addr {
 		uint32_t	addr32{};
@@ -56,6 +88,21 @@ namespace Carnival::Network {
 	struct PacketInfo {
 		ipv4_addr fromAddr{};
 		uint16_t fromPort{};
+		uint16_t segmentSize{}; // GRO: size of each coalesced datagram, 0 if not coalesced
+	};
+	// caller-owned memory filled by a batched receive
+	struct ReceiveSlot {
+		std::byte*	data{ nullptr };
+		uint32_t	capacity{};
+		uint32_t	size{}; // bytes received
+		PacketInfo	info{};
+	};
+	// outgoing datagram for a batched send, data must outlive the call
+	struct SendSlot {
+		const std::byte*	data{ nullptr };
+		uint32_t			size{};
+		ipv4_addr			addr{};
+		uint16_t			port{};
 	};
 	enum class PollResult : uint8_t {
 		None,
@@ -86,12 +133,62 @@ namespace Carnival::Network {
 		SNAPSHOT	= 1 << 5,
 		  // FRAGMENT
 		FRAGMENT	= 1 << 6,
+		// 96 more ack bits follow the header, on a handshake advertises support
+		WIDE_ACK	= 1 << 7,
+	};
+	// Header flag of a logical channel
+	constexpr PacketFlags channelFlag(uint8_t channel) noexcept {
+		switch (channel) {
+		case CH_UNRELIABLE:	return UNRELIABLE;
+		case CH_RELIABLE:	return RELIABLE;
+		case CH_SNAPSHOT:	return SNAPSHOT;
+		default:			return INVALID;
+		}
+	}
+	// Outcome of one datagram. Only Malformed counts against its source, anyone can spoof
+	// a source address onto a stale or out of window packet
+	enum class PacketResult : uint8_t {
+		Handled,
+		Dropped,
+		Malformed
+	};
+	// Framed message prefix, messages queued in a tick share a packet back to back.
+	// Type in the top 5 bits, length in the low 11, larger messages go out as a fragment batch
+	// holding a single frame, its length field unused.
+	// Ordered messages follow the prefix with their stream and the stream's sequence
+	struct MessagePrefix {
+		static constexpr uint32_t SIZE{ sizeof(uint16_t) };
+		static constexpr uint16_t LENGTH_MASK{ (1 << 11) - 1 };
+		static constexpr uint8_t ORDERED{ 1 << 4 }; // type bit
+		static constexpr uint32_t ORDERED_SIZE{ sizeof(uint8_t) + sizeof(uint16_t) };
+
+		static constexpr uint16_t pack(uint8_t type, uint32_t length) noexcept {
+			return static_cast<uint16_t>((type << 11) | length);
+		}
+		static constexpr uint8_t type(uint16_t prefix) noexcept { return static_cast<uint8_t>(prefix >> 11); }
+		static constexpr uint16_t length(uint16_t prefix) noexcept { return prefix & LENGTH_MASK; }
 	};
+	static_assert(PACKET_PAYLOAD <= MessagePrefix::LENGTH_MASK, "Framed length must cover a packet");
+	static_assert(FRAGMENT_PAYLOAD < PACKET_PAYLOAD - MessagePrefix::SIZE, "Unframed messages must span two fragments");
 	struct FragmentLoad {
 		uint16_t batchNumber{};
 		uint16_t FRAGMENT_COUNT{};
 		uint16_t fragmentIndex{};
 	};
+	// Position in an FEC group, leads every unreliable payload. Indices from dataCount up are parity,
+	// whose body starts with the XOR of the covered lengths and packet types
+	struct FecLoad {
+		static constexpr uint32_t SIZE{ sizeof(uint16_t) + 3 * sizeof(uint8_t) };
+		static constexpr uint32_t PARITY_SIZE{ sizeof(uint16_t) + sizeof(uint8_t) };
+
+		uint16_t group{};
+		uint8_t index{};
+		uint8_t dataCount{}; // 0 when the sender runs without FEC
+		uint8_t parityCount{};
+	};
+	// Unreliable payload body, leaves a parity packet room for its length and type
+	static constexpr uint32_t UNRELIABLE_PAYLOAD = PACKET_MTU - HEADER_SIZE - FecLoad::SIZE - FecLoad::PARITY_SIZE;
+	static_assert(MAX_FEC_DATA + MAX_FEC_PARITY <= 32, "FEC received bitmap is 32 bits");
 	// Wire Format
 	struct PacketHeader {
 		uint32_t	PROTOCOL_VERSION{ HEADER_VERSION };
@@ -111,6 +208,7 @@ namespace Carnival::Network {
 		uint32_t ackField{};
 		uint32_t lastSeqRecv{};
 		uint32_t sessionID{};
+		std::array<uint32_t, WIDE_ACK_BITS / 32 - 1> ackFieldExt{}; // bit n of word k acks lastSeqRecv - 32(k+1) - n
 		FragmentLoad fragLoad{};
 		PacketFlags flags{ INVALID };
 		uint8_t offset{}; // Byte offset to payload
@@ -131,24 +229,285 @@ namespace Carnival::Network {
 		ipv4_addr	addr{};
 		uint16_t	port{};
 		uint16_t	retryCount{};
+		uint64_t	cookie{}; // echoed in requests once the peer challenged, 0 before
 	};
+	// Connection requests carry a cookie slot, zero until challenged, so a challenge is never larger
+	// than the request that provoked it. A reject carrying a cookie is a challenge
+	static constexpr uint32_t COOKIE_SIZE = sizeof(uint64_t);
 
 	struct ReliabilityPolicy { // time in MicroSeconds
-		uint32_t resendDelay	= 350'000;
-		uint32_t maxResendDelay = 350'000'0;
+		uint32_t resendDelay	= 350'000; // RTO until the first RTT sample
+		uint32_t minResendDelay	= 20'000; // RTO floor, covers peer ack delay on LAN
+		uint32_t maxResendDelay = 350'000'0; // RTO and backoff ceiling
 		uint32_t disconnect		= 5'500'000;
 		uint32_t heartbeat		= 2'350'000; // Time since last send
 		uint32_t maxRetries		= 10;
+		uint32_t fastRetransmitThreshold = 3; // newer acks past a hole before resending it early, 0 disables
+		uint32_t ackDelay		= 10'000; // Hold an ack-only packet this long for a payload to piggyback on
+		uint32_t ackThreshold	= 8; // Unacked arrivals that send the ack without waiting out the delay
+		uint32_t initialWindow	= 10; // reliable packets in flight before the first ack
+		uint32_t minWindow		= 2; // congestion window floor, also the window after a timeout
+		uint32_t pacingBurst	= 4; // packets a session may send back to back, 0 disables pacing
+		uint32_t cookieLifetime	= 5'000'000; // handshake cookies are accepted for one to two of these
+		uint32_t maxQueued		= 256; // reliable packets waiting on the window, messages are refused past it
+	};
+	static_assert(ReliabilityPolicy{}.maxQueued > MAX_FRAGMENTS, "A full fragment batch must fit the send queue");
+	// Per-source limits applied before a header is parsed
+	struct IngressPolicy {
+		uint32_t sourceRate		= 4096; // sustained datagrams per second per address, 0 disables the filter
+		uint32_t sourceBurst	= 1024; // datagrams an idle address may send back to back
+		uint32_t dropThreshold	= 256; // malformed datagrams within a second that ban an address and port, 0 never bans
+		uint32_t banDuration	= 10'000'000; // microseconds
+		uint32_t banPorts		= 4; // ports of one address banned within banDuration that ban the whole address
+		uint32_t sources		= 4096; // addresses tracked, a new one evicts the longest idle
+	};
+	// Transport options, fixed at construction
+	struct NetworkConfig {
+		bool useIoUring = false; // Linux only, falls back to plain socket calls if the kernel refuses
+		bool useSegmentationOffload = false; // UDP GSO bursts and GRO receives, Linux only
+		// Every channel over the reliable socket, demultiplexed by header flags.
+		// Both peers must agree, a dual-socket peer drops channels arriving on the wrong port.
+		bool singleSocket = false;
+		// Read ready sockets until they would block, one readiness check per tick instead of per batch
+		bool drainReceive = false;
+		uint32_t receiveBudget = 1024; // datagrams read per tick when draining, the rest wait a tick
+		// Between ticks block on the sockets until this close to the deadline, then spin.
+		// Covers wake-up latency, raising it to the tick length restores a pure busy-wait.
+		uint32_t spinTailUs = 200;
+		// Offer 128-bit acks in the handshake, the extension is only sent when 32 bits fall short
+		bool wideAcks = true;
+		// FEC on the unreliable channels: every fecGroupSize payloads are followed by fecParityCount
+		// XOR parity packets, each recovering one loss among the payloads it covers. 0 disables,
+		// receiving works either way
+		uint8_t fecGroupSize = 0; // up to MAX_FEC_DATA, clamped
+		uint8_t fecParityCount = 1; // 1 to MAX_FEC_PARITY and no more than the group size, clamped
+		IngressPolicy ingress{};
+		// Clock behind protocol timing, e.g. Engine::getTscTime once TscClock is calibrated
+		Engine::TimeSource timeSource = &Engine::getTime;
 	};
 	//======================================== Session =============================//
 
+	// Receive history, bit n marks lastReceived - n as received
+	struct AckBitmap {
+		std::array<uint32_t, WIDE_ACK_BITS / 32> words{};
+
+		// Advance lastReceived by n
+		void shift(uint32_t n) noexcept {
+			const uint32_t wordShift{ n / 32 };
+			const uint32_t bitShift{ n % 32 };
+			for (size_t i{ words.size() }; i-- > 0;) {
+				uint32_t word{};
+				if (i >= wordShift) {
+					word = words[i - wordShift] << bitShift;
+					if (bitShift && i > wordShift) word |= words[i - wordShift - 1] >> (32 - bitShift);
+				}
+				words[i] = word;
+			}
+		}
+		void set(uint32_t bit) noexcept {
+			if (bit < WIDE_ACK_BITS) words[bit / 32] |= 1u << (bit % 32);
+		}
+		bool test(uint32_t bit) const noexcept {
+			return bit < WIDE_ACK_BITS && (words[bit / 32] & (1u << (bit % 32)));
+		}
+	};
+
 	struct ChannelState {
 		uint32_t	receivedACKField{}; // Acks of sent messages
 		uint32_t	lastSent{}; // last sent sequence number
-		uint32_t	sendingAckF{};
+		AckBitmap	sendingAck{};
 		uint32_t	lastReceived{}; // last received sequence number
+		uint32_t	ackReported{}; // lastReceived as of the last header written
+		bool		wideAckPending{ false }; // received something only the extension can ack
+		uint64_t	ackDueTime{}; // ack-only deadline, 0 while every arrival has been acked
+		uint32_t	unackedCount{}; // arrivals since the last header carrying acks
+		uint16_t	batchNumber{}; // next outgoing fragment batch
+	};
+	// Fragment batches already delivered, bit n is the batch n behind the newest.
+	// A resent fragment of one must not start its assembly over
+	struct CompletedBatches {
+		AckBitmap	seen{};
+		uint16_t	newest{};
+		bool		any{ false };
+
+		// Batches further behind than the bitmap reaches count as delivered, the sender
+		// can't still be resending them with RESEND_WINDOW packets in flight
+		bool contains(uint16_t batch) const noexcept {
+			if (!any) return false;
+			const uint16_t behind{ static_cast<uint16_t>(newest - batch) };
+			if (static_cast<int16_t>(behind) < 0) return false;
+			return behind >= WIDE_ACK_BITS || seen.test(behind);
+		}
+		void insert(uint16_t batch) noexcept {
+			const uint16_t behind{ static_cast<uint16_t>(newest - batch) };
+			if (!any || static_cast<int16_t>(behind) < 0) {
+				seen.shift(any ? static_cast<uint16_t>(batch - newest) : 0);
+				newest = batch;
+				any = true;
+				seen.set(0);
+				return;
+			}
+			seen.set(behind);
+		}
+	};
+	static_assert(RESEND_WINDOW / 2 <= WIDE_ACK_BITS, "a batch is at least two packets");
+
+	// Fragment batch being reassembled, each fragment is copied once straight to its final offset
+	struct FragmentAssembly {
+		std::unique_ptr<std::byte[]> data; // allocated for a batch, freed once it is delivered
+		uint64_t	received{}; // bit n set once fragment n landed
+		uint32_t	capacity{}; // fragments data can hold
+		uint32_t	size{}; // payload bytes so far, final once complete
 		uint16_t	batchNumber{};
-		uint16_t	FRAGMENT_COUNT{};
+		uint16_t	count{}; // 0 while unused
+		uint16_t	receivedCount{};
+
+		void reset(uint16_t batch, uint16_t fragments) {
+			static_assert(MAX_FRAGMENTS <= 64, "received bitmap is 64 bits");
+			if (capacity < fragments) {
+				data = std::make_unique_for_overwrite<std::byte[]>(static_cast<uint64_t>(fragments) * FRAGMENT_PAYLOAD);
+				capacity = fragments;
+			}
+			received = 0;
+			size = 0;
+			batchNumber = batch;
+			count = fragments;
+			receivedCount = 0;
+		}
+		bool complete() const noexcept { return count && receivedCount == count; }
+		// Copy fragment into place, false for a duplicate
+		bool add(uint16_t index, std::span<const std::byte> payload) noexcept {
+			const uint64_t bit{ 1ull << index };
+			if (received & bit) return false;
+			std::memcpy(data.get() + static_cast<uint64_t>(index) * FRAGMENT_PAYLOAD, payload.data(), payload.size());
+			received |= bit;
+			receivedCount++;
+			size += static_cast<uint32_t>(payload.size());
+			return true;
+		}
+		std::span<const std::byte> view() const noexcept { return { data.get(), size }; }
+		// Delivered, a session would otherwise keep every slot's largest batch for good
+		void release() noexcept {
+			data.reset();
+			capacity = 0;
+			count = 0;
+		}
+	};
+	// One ordered stream, messages past a hole wait here and only this stream stalls on it
+	struct OrderedStream {
+		static_assert(std::has_single_bit(ORDERED_WINDOW), "Ring index masks the sequence");
+		struct Held {
+			std::vector<std::byte> data;
+			uint16_t sequence{};
+			uint8_t type{};
+			bool present{ false };
+		};
+		std::vector<Held> held; // ring of ORDERED_WINDOW by sequence, allocated only while something waits
+		uint32_t heldCount{};
+		uint16_t nextSend{};
+		uint16_t sendFloor{}; // oldest sequence that may be unacked, as of the last check
+		uint16_t nextDeliver{};
+
+		// Arrival less than ORDERED_WINDOW ahead of nextDeliver, returns the bytes newly held
+		uint64_t hold(uint16_t sequence, uint8_t type, std::span<const std::byte> message) {
+			if (held.empty()) held.resize(ORDERED_WINDOW);
+			auto& slot{ held[sequence & (ORDERED_WINDOW - 1)] };
+			if (slot.present) return 0; // duplicate
+			slot.data.assign(message.begin(), message.end());
+			slot.sequence = sequence;
+			slot.type = type;
+			slot.present = true;
+			heldCount++;
+			return message.size();
+		}
+		// Held message for nextDeliver, null while the hole is open
+		Held* next() noexcept {
+			if (!heldCount) return nullptr;
+			auto& slot{ held[nextDeliver & (ORDERED_WINDOW - 1)] };
+			return (slot.present && slot.sequence == nextDeliver) ? &slot : nullptr;
+		}
+		// Frees the message, and the ring once nothing waits, slot is dangling after
+		void release(Held& slot) noexcept {
+			slot.present = false;
+			slot.data = {};
+			if (--heldCount == 0) held = {};
+		}
+	};
+	// First sequence of each ordered stream a reliable packet carries, later ones in it are higher
+	struct OrderedMarks {
+		std::array<uint16_t, ORDERED_STREAMS> first{};
+		uint8_t streams{}; // bit per stream present
+
+		void mark(uint8_t stream, uint16_t sequence) noexcept {
+			if (streams & (1u << stream)) return;
+			streams |= static_cast<uint8_t>(1u << stream);
+			first[stream] = sequence;
+		}
+	};
+	// XOR of the packets in one interleave class, zero padded to the longest
+	struct FecParity {
+		std::array<std::byte, UNRELIABLE_PAYLOAD> bytes{};
+		uint16_t length{}; // XOR of the covered lengths
+		uint16_t extent{}; // longest covered, bytes past it are still zero
+		uint8_t type{}; // XOR of the covered packet types
+
+		void add(uint16_t bodyLength, uint8_t packetType, std::span<const std::byte> body) noexcept {
+			size_t i{};
+			for (; i + sizeof(uint64_t) <= body.size(); i += sizeof(uint64_t)) {
+				uint64_t acc{}, word{};
+				std::memcpy(&acc, bytes.data() + i, sizeof(acc));
+				std::memcpy(&word, body.data() + i, sizeof(word));
+				acc ^= word;
+				std::memcpy(bytes.data() + i, &acc, sizeof(acc));
+			}
+			for (; i < body.size(); i++) bytes[i] ^= body[i];
+			length ^= bodyLength;
+			type ^= packetType;
+			extent = std::max(extent, static_cast<uint16_t>(body.size()));
+		}
+		void clear() noexcept {
+			std::memset(bytes.data(), 0, extent);
+			length = 0;
+			extent = 0;
+			type = 0;
+		}
+	};
+	// One FEC group. Parity j covers the data indices i with i % parityCount == j, so a burst
+	// of up to parityCount losses lands in different classes and each is recovered on its own
+	struct FecGroup {
+		std::array<FecParity, MAX_FEC_PARITY> classes;
+		uint32_t received{}; // bit per index, data then parity
+		uint16_t group{};
+		uint8_t dataCount{};
+		uint8_t parityCount{};
+		bool active{ false };
+
+		void reset(uint16_t number, uint8_t data, uint8_t parity) noexcept {
+			for (auto& parityClass : classes) parityClass.clear();
+			received = 0;
+			group = number;
+			dataCount = data;
+			parityCount = parity;
+			active = true;
+		}
+		// Only missing data index of a class whose parity arrived, -1 otherwise
+		int32_t recoverable(uint8_t parityClass) const noexcept {
+			if (!(received & (1u << (dataCount + parityClass)))) return -1;
+			int32_t missing{ -1 };
+			for (uint32_t i{ parityClass }; i < dataCount; i += parityCount) {
+				if (received & (1u << i)) continue;
+				if (missing >= 0) return -1;
+				missing = static_cast<int32_t>(i);
+			}
+			return missing;
+		}
+	};
+	// FEC on one unreliable channel, the receive side keeps the previous group for late packets
+	struct FecState {
+		FecGroup send;
+		std::array<FecGroup, 2> receive; // by group number parity
+		uint16_t nextGroup{};
+		uint8_t nextIndex{};
 	};
 	// Remote endpoint activity and data
 	struct Endpoint {
@@ -158,35 +517,88 @@ namespace Carnival::Network {
 		uint16_t	port{};
 		ConnectionState state{ ConnectionState::CONNECTING };
 	};
-	// Logical Connection
-	struct Session {
-		std::array<Endpoint, SOCKET_COUNT>	endpoint; // 0 - High Frequency Unreliable, 1 - Reliable, Snapshots
-		std::array<ChannelState, CHANNELS>	states; // 0 - Unreliable, 1 - Reliable Unordered, 2 - Snapshot
+	struct Session;
 
-		uint64_t graceTimer{};
-	};
+	// MTU-sized slots for reliable payloads, O(1) acquire and release.
+	// Allocates only when exhausted, doubling, so it tracks the traffic actually in flight.
+	class PacketPool {
+	public:
+		static constexpr uint64_t SLOT_ALIGN{ 64 };
+		static constexpr uint64_t SLOT_SIZE{ (PACKET_MTU + SLOT_ALIGN - 1) & ~(SLOT_ALIGN - 1) };
 
-	//=========================================== Command ===================================//
+		explicit PacketPool(uint32_t slotCount = 0) { if (slotCount) grow(slotCount); }
+		~PacketPool() noexcept {
+			for (auto* chunk : m_Chunks) ::operator delete[](chunk, std::align_val_t{ SLOT_ALIGN });
+		}
+
+		PacketPool(const PacketPool&) = delete;
+		PacketPool& operator=(const PacketPool&) = delete;
+		PacketPool(PacketPool&&) = delete;
+		PacketPool& operator=(PacketPool&&) = delete;
+
+		std::byte* acquire() {
+			if (m_Free.empty()) grow(m_Capacity ? m_Capacity : 64);
+			std::byte* slot{ m_Free.back() };
+			m_Free.pop_back();
+			return slot;
+		}
+		// Free list was reserved to full capacity on grow, never allocates
+		void release(std::byte* slot) noexcept { m_Free.push_back(slot); }
 
-	// Descriptors in resend Arena 
+		uint32_t inUse() const noexcept { return m_Capacity - static_cast<uint32_t>(m_Free.size()); }
+		uint32_t capacity() const noexcept { return m_Capacity; }
+		// Pin every chunk with lock, and each one grown from here on, false if any was refused
+		bool lockChunks(bool (*lock)(const void*, uint64_t) noexcept) {
+			m_Lock = lock;
+			bool locked{ true };
+			for (size_t i{}; i < m_Chunks.size(); i++) locked &= lock(m_Chunks[i], m_ChunkSlots[i] * SLOT_SIZE);
+			return locked;
+		}
+	private:
+		void grow(uint32_t slotCount) {
+			auto* chunk{ new (std::align_val_t{ SLOT_ALIGN }) std::byte[slotCount * SLOT_SIZE] };
+			if (m_Lock) m_Lock(chunk, slotCount * SLOT_SIZE);
+			m_Chunks.push_back(chunk);
+			m_ChunkSlots.push_back(slotCount);
+			m_Capacity += slotCount;
+			m_Free.reserve(m_Capacity);
+			for (uint32_t i{}; i < slotCount; i++) m_Free.push_back(chunk + i * SLOT_SIZE);
+		}
+
+		std::vector<std::byte*> m_Chunks;
+		std::vector<uint32_t> m_ChunkSlots;
+		std::vector<std::byte*> m_Free;
+		bool (*m_Lock)(const void*, uint64_t) noexcept { nullptr };
+		uint32_t m_Capacity{};
+	};
+	// Returns a slot to its pool on destruction
+	struct PoolDeleter {
+		PacketPool* pool{ nullptr };
+		void operator()(std::byte* slot) const noexcept { if (pool) pool->release(slot); }
+	};
+	using PoolBuffer = std::unique_ptr<std::byte[], PoolDeleter>;
+
+	// Reliable packet in flight, empty when pData is null
 	struct PacketDescriptor {
-		std::unique_ptr<std::byte[]> pData; // serialized data buffer
+		PoolBuffer pData; // serialized data buffer, pooled MTU slot
 		uint64_t size{}; // must be less than MTU
 		Session* sesh{ nullptr };
 		uint64_t lastSendTime{};
+		uint64_t deadline{}; // next resend, matches the live timer entry
 		uint32_t sequenceNum{};
 		uint32_t sessionID{};
 		uint16_t resendCount{};
 		bool Acked{ false };
+		bool fastRetransmitted{ false }; // once per packet, further losses wait for the RTO
+		OrderedMarks ordered{};
 
-		PacketDescriptor(std::byte* data,
+		PacketDescriptor() = default;
+		PacketDescriptor(PoolBuffer&& data,
 			uint64_t size, Session* s, uint32_t seq, uint32_t ID)
-			:size{ size }, sesh{ s }, sequenceNum{ seq },
+			:pData{ std::move(data) }, size{ size }, sesh{ s }, sequenceNum{ seq },
 			sessionID{ ID },
 			resendCount{ 0 }, Acked{ false },
-			lastSendTime{ 0 } {
-			pData = std::move(std::unique_ptr<std::byte[]>(data));
-		}
+			lastSendTime{ 0 } {}
 
 		PacketDescriptor(const PacketDescriptor&) = delete;
 		PacketDescriptor& operator=(const PacketDescriptor&) = delete;
@@ -194,8 +606,195 @@ namespace Carnival::Network {
 		PacketDescriptor& operator=(PacketDescriptor&& other) = default;
 	};
 
+	// Per-session reliable packets in flight, slot = sequence % RESEND_WINDOW.
+	// Acks clear slots directly, the send path never seals a packet into an occupied slot.
+	class ResendRing {
+	public:
+		// Store packet, its slot is free
+		PacketDescriptor& insert(PacketDescriptor&& packet) noexcept {
+			auto& slot{ m_Slots[packet.sequenceNum & (RESEND_WINDOW - 1)] };
+			if (!slot.pData) m_InFlight++;
+			slot = std::move(packet);
+			return slot;
+		}
+		// Slot holding sequence, null if acked, released or never stored
+		PacketDescriptor* find(uint32_t sequence) noexcept {
+			auto& slot{ m_Slots[sequence & (RESEND_WINDOW - 1)] };
+			return (slot.pData && slot.sequenceNum == sequence) ? &slot : nullptr;
+		}
+		// Slot the sequence would take still holds an unacked packet
+		bool occupied(uint32_t sequence) const noexcept {
+			return m_Slots[sequence & (RESEND_WINDOW - 1)].pData != nullptr;
+		}
+		void release(PacketDescriptor& slot) noexcept {
+			if (!slot.pData) return;
+			slot.pData.reset();
+			m_InFlight--;
+		}
+		// Clear every slot the peer's ack field covers, bit n acknowledges lastSeq - n.
+		// onAck sees each descriptor before it is released
+		template<typename Fn>
+		uint32_t acknowledge(uint32_t lastSeq, uint32_t ackField, Fn&& onAck) noexcept {
+			uint32_t acked{};
+			for (uint32_t bits{ ackField }; bits; bits &= bits - 1) {
+				if (auto* slot{ find(lastSeq - static_cast<uint32_t>(std::countr_zero(bits))) }) {
+					onAck(*slot);
+					release(*slot);
+					acked++;
+				}
+			}
+			return acked;
+		}
+		template<typename Fn>
+		void forEach(Fn&& fn) const {
+			for (const auto& slot : m_Slots)
+				if (slot.pData) fn(slot);
+		}
+		// Unacked packets with at least threshold newer sequences acked across consecutive ack words,
+		// bit n of word k acknowledges lastSeq - 32k - n
+		template<typename Fn>
+		void forEachHole(uint32_t lastSeq, std::span<const uint32_t> fields, uint32_t threshold, Fn&& onHole) noexcept {
+			if (!threshold || threshold >= fields.size() * 32) return;
+			uint32_t newer{}; // acks in the words before this one
+			for (uint32_t word{}; word < fields.size(); word++) {
+				const uint32_t field{ fields[word] };
+				for (uint32_t holes{ ~field }; holes; holes &= holes - 1) {
+					const uint32_t bit{ static_cast<uint32_t>(std::countr_zero(holes)) };
+					if (newer + static_cast<uint32_t>(std::popcount(field & ((1u << bit) - 1))) < threshold) continue;
+					if (auto* slot{ find(lastSeq - 32 * word - bit) }) onHole(*slot);
+				}
+				newer += static_cast<uint32_t>(std::popcount(field));
+			}
+		}
+		uint32_t inFlight() const noexcept { return m_InFlight; }
+	private:
+		std::array<PacketDescriptor, RESEND_WINDOW> m_Slots{};
+		uint32_t m_InFlight{};
+	};
+
+	// Smoothed round trip of the reliable channel (RFC 6298), microseconds, zero until sampled
+	struct RttEstimate {
+		uint32_t srtt{};
+		uint32_t rttvar{};
+		uint32_t rto{};
+
+		void sample(uint32_t rtt, const ReliabilityPolicy& policy) noexcept {
+			if (!srtt) {
+				srtt = rtt;
+				rttvar = rtt / 2;
+			}
+			else {
+				const uint32_t delta{ srtt > rtt ? srtt - rtt : rtt - srtt };
+				rttvar = (3 * rttvar + delta) / 4;
+				srtt = (7 * srtt + rtt) / 8;
+			}
+			const uint64_t target{ static_cast<uint64_t>(srtt) + 4ull * rttvar };
+			rto = static_cast<uint32_t>(std::clamp<uint64_t>(target, policy.minResendDelay, policy.maxResendDelay));
+		}
+		// Timeout after `sends` transmissions, doubling per resend
+		uint64_t timeout(uint16_t sends, const ReliabilityPolicy& policy) const noexcept {
+			const uint64_t base{ rto ? rto : policy.resendDelay };
+			const uint32_t shift{ sends > 1 ? std::min<uint32_t>(sends - 1u, 16) : 0u };
+			return std::min<uint64_t>(base << shift, policy.maxResendDelay);
+		}
+	};
+	// Loss-based window with slow start and congestion avoidance, counted in reliable packets.
+	// Pacing credit spreads the window over the RTT instead of bursting it out each tick
+	struct CongestionControl {
+		uint32_t window{}; // initialWindow from the policy at session creation
+		uint32_t ssthresh{ UINT32_MAX };
+		uint32_t growth{}; // acks toward the next congestion avoidance step
+		uint32_t recoverySeq{}; // losses sent before this belong to the last reduction
+		int64_t paceCredit{}; // bytes, a packet goes out while it is not negative
+		uint64_t paceTime{}; // last refill
+
+		void onAck(uint32_t acked, uint32_t cap) noexcept {
+			if (window < ssthresh) window += acked;
+			else if ((growth += acked) >= window) { // one packet per window of acks
+				growth -= window;
+				window++;
+			}
+			window = std::min(window, cap);
+		}
+		// Hole in the ack field, halve once per window of data
+		void onLoss(uint32_t sequence, uint32_t nextSequence, const ReliabilityPolicy& policy) noexcept {
+			if (!reduce(sequence, nextSequence, policy)) return;
+			window = ssthresh;
+		}
+		// Resend timer fired, restart from the floor and slow start back to half the old window
+		void onTimeout(uint32_t sequence, uint32_t nextSequence, const ReliabilityPolicy& policy) noexcept {
+			if (!reduce(sequence, nextSequence, policy)) return;
+			window = policy.minWindow;
+		}
+		// Window over one RTT in bytes per second, ahead of it in slow start so the window can still double.
+		// 0 until the first RTT sample, nothing to pace against
+		uint64_t paceRate(uint32_t srtt) const noexcept {
+			if (!srtt) return 0;
+			const uint64_t gain{ window < ssthresh ? 200u : 125u };
+			return static_cast<uint64_t>(window) * PACKET_MTU * 1'000'000 / srtt * gain / 100;
+		}
+		// Refill for the time elapsed, true while a packet may go out
+		bool canSend(uint64_t now, uint64_t rate, uint32_t burst) noexcept {
+			if (!rate || !burst) return true;
+			const uint64_t elapsed{ std::min<uint64_t>(now - paceTime, 1'000'000) };
+			paceCredit = std::min<int64_t>(paceCredit + static_cast<int64_t>(elapsed * rate / 1'000'000),
+				static_cast<int64_t>(burst) * PACKET_MTU);
+			paceTime = now;
+			return paceCredit >= 0;
+		}
+		// When the credit is back to zero
+		uint64_t nextSendTime(uint64_t now, uint64_t rate) const noexcept {
+			return now + (static_cast<uint64_t>(-paceCredit) * 1'000'000 + rate - 1) / rate;
+		}
+	private:
+		bool reduce(uint32_t sequence, uint32_t nextSequence, const ReliabilityPolicy& policy) noexcept {
+			if (static_cast<int32_t>(sequence - recoverySeq) < 0) return false;
+			ssthresh = std::max(window / 2, policy.minWindow);
+			growth = 0;
+			recoverySeq = nextSequence;
+			return true;
+		}
+	};
+	// Reliable packet held back by the congestion window or pacing, the header is written once it is sent
+	struct QueuedPacket {
+		PoolBuffer pData; // payload from offset 0
+		uint64_t size{};
+		FragmentLoad fragment{};
+		PacketFlags flags{ INVALID };
+		OrderedMarks ordered{};
+	};
+
+	// Logical Connection
+	struct Session {
+		std::array<Endpoint, SOCKET_COUNT>	endpoint; // 0 - High Frequency Unreliable, 1 - Reliable, Snapshots
+		std::array<ChannelState, CHANNELS>	states; // 0 - Unreliable, 1 - Reliable Unordered, 2 - Snapshot
+		ResendRing resend; // reliable channel in flight
+		RttEstimate rtt;
+		bool wideAck{ false }; // both peers advertised WIDE_ACK in the handshake
+		std::array<FragmentAssembly, REASSEMBLY_SLOTS> reassembly; // reliable channel fragment batches
+		CompletedBatches completedBatches;
+		std::vector<std::byte> outbox; // framed reliable messages not yet in a packet, at most one packet's worth
+		OrderedMarks outboxOrdered; // streams with messages in the outbox
+		std::array<OrderedStream, ORDERED_STREAMS> streams;
+		uint32_t heldBytes{}; // early ordered messages held across streams, at most MAX_HELD_BYTES
+		CongestionControl congestion;
+		std::deque<QueuedPacket> sendQueue; // sealed in order as the window and pacing allow
+		bool backlogged{ false }; // listed for sendBacklog
+		std::array<std::unique_ptr<FecState>, CHANNELS> fec; // unreliable and snapshot, allocated on first use
+
+		uint64_t graceTimer{};
+	};
+
+	// Session table slot and the generation it was issued for, stale once that session is erased
+	struct SessionHandle {
+		uint32_t index{ UINT32_MAX };
+		uint32_t generation{};
+	};
+
+	//=========================================== Command ===================================//
+
 	struct NetCommand {
-		NetCommand(Session* s, uint32_t id, PacketFlags t)
+		NetCommand(SessionHandle s, uint32_t id, PacketFlags t)
 			: ep{ .sesh = s }, sessionID{ id }, type{ t } {}
 		
 		NetCommand(PacketDescriptor* data, PacketFlags t)
@@ -205,7 +804,7 @@ namespace Carnival::Network {
 			: ep{ .endpoint{.addr = addr, .port = port} }, type{ t } {}
 
 		union { // Can be active session or raw endpoint
-			Session* sesh{ nullptr };
+			SessionHandle sesh{};
 			PacketDescriptor* descriptor;
 			struct {
 				ipv4_addr addr{};
@@ -216,13 +815,69 @@ namespace Carnival::Network {
 		uint32_t sessionID{};
 		PacketFlags type{};
 	};
+
+	// Resend deadline, stale once the slot is acked or rescheduled
+	struct ResendTimer {
+		uint64_t deadline{};
+		uint32_t sessionID{};
+		uint32_t sequenceNum{};
+
+		friend bool operator>(const ResendTimer& a, const ResendTimer& b) noexcept {
+			return a.deadline > b.deadline;
+		}
+	};
 	
+	// Session maintenance deadline in the timer wheel. Checked against the session when it fires,
+	// activity since it was armed just re-arms it, so packets never touch the wheel
+	struct SessionTimer {
+		enum Kind : uint8_t {
+			HEARTBEAT, // endpoint idle since its last send
+			TIMEOUT, // endpoint silent since its last receive
+			GRACE, // dropping session due for removal
+			RETRY, // pending handshake, keyed by address
+		};
+		uint64_t address{}; // RETRY only, addressKey of the pending peer
+		SessionHandle sesh{};
+		uint32_t sessionID{};
+		uint8_t endpoint{};
+		Kind kind{ HEARTBEAT };
+	};
+
 	//=========================================== DEBUG ===================================//
 	struct NetworkStats {
 		uint64_t packetsSent{};
 		uint64_t packetsReceived{};
 		uint64_t packetsDropped{};
+		uint64_t sendsDropped{}; // queued to the ring but failed in the kernel
 		uint64_t bytesSent{};
 		uint64_t bytesReceived{};
+		uint64_t packetsHandedOff{}; // received by one worker, owned by another
+		uint64_t fastRetransmits{}; // resends triggered by ack gaps rather than the RTO
+		uint64_t payloadSlotsInUse{}; // reliable payload pool occupancy
+		uint64_t payloadSlotsTotal{};
+		uint64_t messagesSent{}; // framed or fragmented, several share a packet
+		uint64_t messagesReceived{};
+		uint64_t fecRecovered{}; // unreliable payloads rebuilt from parity
+		uint64_t packetsFiltered{}; // refused by the ingress filter, never parsed
+		uint64_t sourcesBanned{};
+
+		NetworkStats& operator+=(const NetworkStats& other) noexcept {
+			packetsSent += other.packetsSent;
+			packetsReceived += other.packetsReceived;
+			packetsDropped += other.packetsDropped;
+			sendsDropped += other.sendsDropped;
+			bytesSent += other.bytesSent;
+			bytesReceived += other.bytesReceived;
+			packetsHandedOff += other.packetsHandedOff;
+			fastRetransmits += other.fastRetransmits;
+			payloadSlotsInUse += other.payloadSlotsInUse;
+			payloadSlotsTotal += other.payloadSlotsTotal;
+			messagesSent += other.messagesSent;
+			messagesReceived += other.messagesReceived;
+			fecRecovered += other.fecRecovered;
+			packetsFiltered += other.packetsFiltered;
+			sourcesBanned += other.sourcesBanned;
+			return *this;
+		}
 	};
 }
\ No newline at end of file
@@ -1,13 +1,19 @@
 #pragma once
 #include <print>
 
+#ifdef _MSC_VER
+	#define CL_DEBUGBREAK() __debugbreak()
+#else
+	#define CL_DEBUGBREAK() __builtin_trap()
+#endif
+
 #ifdef CL_ENABLE_ASSERTS
 	#define CL_CORE_ASSERT(x, ...) \
 		do { \
 			if(!(x)) { \
 				std::print("Assertion Failed: "); \
 				std::print(__VA_ARGS__); \
-				__debugbreak(); \
+				CL_DEBUGBREAK(); \
 			} \
 		} while(0)
 #else
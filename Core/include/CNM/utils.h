@@ -1,6 +1,9 @@
 #pragma once
 #include <string_view>
 #include <chrono>
+#include <cstdint>
+#include <bit>
+#include <span>
 namespace Carnival::utils {
 	// ========================= Hash ============================ //
 	constexpr uint32_t FNV32_OFFSET_BASIS{ 0x811C9DC5u };
@@ -36,14 +39,39 @@ namespace Carnival::utils {
 		}
 		return hash;
 	}
+
+	// SipHash-2-4 over whole 64-bit words, keyed so a peer cannot forge the result
+	inline uint64_t siphash24(uint64_t k0, uint64_t k1, std::span<const uint64_t> words) noexcept {
+		uint64_t v0{ 0x736f6d6570736575ull ^ k0 };
+		uint64_t v1{ 0x646f72616e646f6dull ^ k1 };
+		uint64_t v2{ 0x6c7967656e657261ull ^ k0 };
+		uint64_t v3{ 0x7465646279746573ull ^ k1 };
+		auto round = [&]() {
+			v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+			v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+			v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+			v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+		};
+		auto compress = [&](uint64_t m) {
+			v3 ^= m;
+			round(); round();
+			v0 ^= m;
+		};
+		for (uint64_t m : words) compress(m);
+		compress(static_cast<uint64_t>(words.size() * sizeof(uint64_t)) << 56);
+		v2 ^= 0xff;
+		round(); round(); round(); round();
+		return v0 ^ v1 ^ v2 ^ v3;
+	}
 }
 
 namespace Carnival::Engine {
+	// Monotonic microseconds from the clock's own epoch, no static to guard on every call
 	inline uint64_t getTime() noexcept
 	{
-		// thread safe but slow
-		static const auto start = std::chrono::steady_clock::now();
-		return (std::chrono::duration_cast<std::chrono::microseconds>(
-			std::chrono::steady_clock::now() - start).count());
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
 	}
+	// Microsecond clock the network thread reads, getTime unless a faster one is injected
+	using TimeSource = uint64_t(*)() noexcept;
 }
\ No newline at end of file
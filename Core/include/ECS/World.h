@@ -406,8 +406,13 @@ namespace Carnival::ECS {
 		void startUpdate();
 		void endUpdate();
 
-		// Do not store
-		ReplicationContext& getShardContext(uint16_t PeerID) { return m_Shards[0]; } // temp
+		// One context per network worker, each worker touches only its own. Do not store
+		ReplicationContext& getShardContext(uint16_t shard) {
+			CL_CORE_ASSERT(shard < m_Shards.size(), "Shard out of range, setShardCount first");
+			return m_Shards[shard];
+		}
+		// Before any worker starts, contexts are not safe to add while they run
+		void setShardCount(uint16_t count) { m_Shards.resize(std::max<uint16_t>(count, 1)); }
 	private:
 		Entity createEntity(std::vector<uint64_t> components, NetworkFlags flag = NetworkFlags::LOCAL);
 
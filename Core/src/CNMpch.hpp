@@ -3,6 +3,7 @@
 // STANDARD LIBRARY
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -27,7 +28,15 @@
 #if defined(CL_Platform_Linux) || defined(CL_Platform_Mac)
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
 #include <fcntl.h>
+#include <cerrno>
+#endif
+
+#ifdef CL_Platform_Linux
+#include <netinet/udp.h>
 #endif
 
 // CNM
@@ -26,38 +26,31 @@ namespace Carnival::ECS {
 	{
 		Entity eID{};
 		while (m_ReplicationBuffer.pop(eID)) {
-			// Resolve Entity -> Shards
-			// single shard only for now
-			uint16_t shardIndex = 0;
-
-			auto& currShard = m_Shards[shardIndex];
-
 			const auto rec = m_EntityManager.get(eID);
 
-			currShard.reliableStagingBuffer.reset();
-			rec.pArchetype->serializeIndex(rec.index, currShard.reliableStagingBuffer);
-
 			auto pData = static_cast<OnUpdateNetworkComponent*>
 				(rec.pArchetype->getComponentData(OnUpdateNetworkComponent::ID));
 			auto& comp = pData[rec.index];
 
 			uint64_t NetID = comp.networkID;
-			
-			auto& snapshot = currShard.entityTable[NetID];
 
-			if (snapshot.version >= comp.version) {
+			// Every shard keeps its own copy, a worker never reads another's table
+			for (auto& currShard : m_Shards) {
+				auto& snapshot = currShard.entityTable[NetID];
 				// version mismatch, deal with it
-				comp.dirty = false;
-				continue;
-			}
+				if (snapshot.version >= comp.version) continue;
 
-			snapshot.version = comp.version;
-			snapshot.size = currShard.reliableStagingBuffer.size();
+				currShard.reliableStagingBuffer.reset();
+				rec.pArchetype->serializeIndex(rec.index, currShard.reliableStagingBuffer);
 
-			if (snapshot.pSerializedData) delete[] snapshot.pSerializedData;
-			snapshot.pSerializedData = new std::byte[currShard.reliableStagingBuffer.size()]();
-			auto toBeCopied = currShard.reliableStagingBuffer.getReadyMessages();
-			std::memcpy(snapshot.pSerializedData, toBeCopied.data(), toBeCopied.size());
+				snapshot.version = comp.version;
+				snapshot.size = currShard.reliableStagingBuffer.size();
+
+				if (snapshot.pSerializedData) delete[] snapshot.pSerializedData;
+				snapshot.pSerializedData = new std::byte[currShard.reliableStagingBuffer.size()]();
+				auto toBeCopied = currShard.reliableStagingBuffer.getReadyMessages();
+				std::memcpy(snapshot.pSerializedData, toBeCopied.data(), toBeCopied.size());
+			}
 
 			comp.dirty = false;
 		}
@@ -106,29 +99,31 @@ namespace Carnival::ECS {
 		// stage reliable updates
 		updateReliable();
 
-		// Temporary 1 shard solution:
-		auto& u_idx = m_Shards[0].unreliableIndex;
-
-		// Set Replication Write Active
-		auto expected = u_idx->load(std::memory_order::relaxed);
-		BufferIndex idx{};
-		do {
-			idx = expected;
-			idx.writerActive = true;
-		} while (!u_idx->compare_exchange_strong(expected, idx, std::memory_order::release, std::memory_order::relaxed));
-
-		// Replicate Records
-		replicateUnreliable(0);
-
-		// Swap Buffers, Set Replication Inactive
-		do {
-			expected = u_idx->load(std::memory_order::relaxed);
-			idx = expected;
-			if (!idx.readerActive) {
-				idx.writerIndex ^= 1;
-				idx.readerIndex ^= 1;
-			}
-			idx.writerActive = false;
-		} while (!u_idx->compare_exchange_strong(expected, idx, std::memory_order::release, std::memory_order::relaxed));
+		// Each worker reads its own shard's buffers
+		for (uint16_t shard{}; shard < m_Shards.size(); shard++) {
+			auto& u_idx = m_Shards[shard].unreliableIndex;
+
+			// Set Replication Write Active
+			auto expected = u_idx->load(std::memory_order::relaxed);
+			BufferIndex idx{};
+			do {
+				idx = expected;
+				idx.writerActive = true;
+			} while (!u_idx->compare_exchange_strong(expected, idx, std::memory_order::release, std::memory_order::relaxed));
+
+			// Replicate Records
+			replicateUnreliable(shard);
+
+			// Swap Buffers, Set Replication Inactive
+			do {
+				expected = u_idx->load(std::memory_order::relaxed);
+				idx = expected;
+				if (!idx.readerActive) {
+					idx.writerIndex ^= 1;
+					idx.readerIndex ^= 1;
+				}
+				idx.writerActive = false;
+			} while (!u_idx->compare_exchange_strong(expected, idx, std::memory_order::release, std::memory_order::relaxed));
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include <src/CNMpch.hpp>
+
+#include <CNM/Clock.h>
+
+#if defined(CL_X64) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+namespace {
+	bool invariantTsc() noexcept
+	{
+#ifdef CL_X64
+		// CPUID 0x80000007 EDX bit 8, constant rate through P-states and idle
+		uint32_t regs[4]{};
+	#ifdef _MSC_VER
+		int info[4]{};
+		__cpuid(info, 0x80000000);
+		if (static_cast<uint32_t>(info[0]) < 0x80000007) return false;
+		__cpuid(info, 0x80000007);
+		regs[3] = static_cast<uint32_t>(info[3]);
+	#else
+		if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+		__get_cpuid(0x80000007, &regs[0], &regs[1], &regs[2], &regs[3]);
+	#endif
+		return regs[3] & (1u << 8);
+#else
+		return false;
+#endif
+	}
+}
+
+namespace Carnival::Engine {
+	bool TscClock::calibrate(uint32_t windowUs) noexcept
+	{
+		if (!invariantTsc()) return false;
+		CL_CORE_ASSERT(windowUs >= 1'000, "Calibration window too short to be accurate");
+
+		// Pair a steady_clock reading with the ticks around it, in nanoseconds so the microsecond
+		// rounding of getTime stays out of the rate. Tightest of a few tries, a preempted one is useless
+		auto sample = [](uint64_t& stamp, uint64_t& nanos) {
+			uint64_t narrowest{ UINT64_MAX };
+			for (uint32_t attempt{}; attempt < 8; attempt++) {
+				const uint64_t before{ ticks() };
+				const uint64_t reading{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now().time_since_epoch()).count()) };
+				const uint64_t width{ ticks() - before };
+				if (width >= narrowest) continue;
+				narrowest = width;
+				stamp = before + width / 2;
+				nanos = reading;
+			}
+		};
+		uint64_t startTicks{}, startNanos{};
+		sample(startTicks, startNanos);
+		uint64_t endTicks{}, endNanos{};
+		do {
+			SpinPause();
+			sample(endTicks, endNanos);
+		} while (endNanos - startNanos < windowUs * 1'000ull);
+
+		const uint64_t elapsedTicks{ endTicks - startTicks };
+		const uint64_t elapsedNanos{ endNanos - startNanos };
+		if (elapsedTicks * 1'000 < elapsedNanos) return false; // under 1MHz, not a usable counter
+
+		s_NanoMultiplier = (elapsedNanos << 32) / elapsedTicks;
+		s_MicroMultiplier = (elapsedNanos << 32) / (elapsedTicks * 1'000);
+		s_BaseTicks = endTicks;
+		s_BaseMicros = endNanos / 1'000;
+		return true;
+	}
+}
@@ -1,12 +1,19 @@
 #include <src/CNMpch.hpp>
 
 #include <CNM/NetworkManager.h>
+#include <CNM/NetworkWorkerPool.h>
 #include <ECS/World.h>
 
 using namespace Carnival::Engine;
 
 namespace {
 	constexpr uint8_t TYPE_MASK = 0b00000111;
+	constexpr uint64_t GSO_MAX_SEGMENTS = 64; // UDP_MAX_SEGMENTS on older kernels
+	// Receive slab geometry, GRO slots must hold a whole coalesced burst
+	constexpr uint32_t RECV_SLOTS = 128;
+	constexpr uint32_t GRO_RECV_SLOTS = 16;
+	// Wire offset of the session ID, after protocol, flags, sequence, ack field and last received
+	constexpr uint64_t SESSION_ID_OFFSET = 17;
 	constexpr uint8_t CHANNEL_MASK = Carnival::Network::UNRELIABLE | 
 		Carnival::Network::RELIABLE | 
 		Carnival::Network::SNAPSHOT;
@@ -22,177 +29,372 @@ namespace {
 namespace Carnival::Network {
 	NetworkManager::NetworkManager(ECS::World* pWorld,
 		const SocketData& relSockData, const SocketData& urelSockData,
-		uint16_t maxSessions)
-		: m_pWorld{ pWorld }, m_MaxSessions{ maxSessions }
-	{
-		m_Socks[0].setInAddress(urelSockData.InAddress);
-		m_Socks[0].setPort(urelSockData.InPort);
-		m_Socks[0].setNonBlocking(urelSockData.status & SocketStatus::NONBLOCKING);
-		m_Socks[0].openSocket();
-		m_Socks[0].bindSocket();
+		uint16_t maxSessions, const NetworkConfig& config)
+		: m_RecvSlab{ config.useSegmentationOffload ? GRO_RECV_SLOTS : RECV_SLOTS,
+			config.useSegmentationOffload ? GRO_MAX_SIZE : PACKET_MTU },
+		m_Ingress{ config.ingress },
+		m_Clock{ config.timeSource },
+		m_Timers{ m_Clock.now() },
+		m_PendingIndex{ 64 },
+		m_PayloadPool{ RESEND_WINDOW }, // a session's worth, idle sessions hold no slots
+		m_Sessions{ maxSessions },
+		m_pWorld{ pWorld }, m_Config{ config }, m_MaxSessions{ maxSessions }
+	{
+		// Single-socket mode leaves the unreliable socket closed
+		if (!m_Config.singleSocket) {
+			m_Socks[0].setInAddress(urelSockData.InAddress);
+			m_Socks[0].setPort(urelSockData.InPort);
+			m_Socks[0].setNonBlocking(urelSockData.status & SocketStatus::NONBLOCKING);
+			m_Socks[0].setGRO(m_Config.useSegmentationOffload);
+			m_Socks[0].setReusePort(urelSockData.status & SocketStatus::REUSEPORT);
+			m_Socks[0].openSocket();
+			m_Socks[0].bindSocket();
+		}
 		m_Socks[1].setInAddress(relSockData.InAddress);
 		m_Socks[1].setPort(relSockData.InPort);
 		m_Socks[1].setNonBlocking(relSockData.status & SocketStatus::NONBLOCKING);
+		m_Socks[1].setGRO(m_Config.useSegmentationOffload);
+		m_Socks[1].setReusePort(relSockData.status & SocketStatus::REUSEPORT);
 		m_Socks[1].openSocket();
 		m_Socks[1].bindSocket();
 
-		m_PacketBuffer.reserve(PACKET_MTU);
+		// Disabled again on the first send the kernel refuses
+		m_GSOEnabled = m_Config.useSegmentationOffload;
+		if (m_GSOEnabled) {
+			m_GSOBuffer.reserve(GRO_MAX_SIZE);
+			m_PayloadBatch.reserve(64);
+		}
+
+		if (m_Config.useIoUring) {
+			// Ring socket index matches the endpoint index, or is 0 for the lone reliable socket
+			const std::array<uint64_t, SOCKET_COUNT> handles{ m_Socks[0].getHandle(), m_Socks[1].getHandle() };
+			const auto ringHandles{ m_Config.singleSocket
+				? std::span<const uint64_t>{ handles }.subspan(EP_RELIABLE, 1)
+				: std::span<const uint64_t>{ handles } };
+			if (!m_Ring.init(ringHandles, m_Socks[0].isGRO() || m_Socks[1].isGRO()))
+				std::print("io_uring unavailable, using socket calls.\n");
+		}
+
+		// Parity classes index by count and the received bitmap has room for MAX_FEC_DATA + MAX_FEC_PARITY
+		if (m_Config.fecGroupSize) {
+			const uint8_t group{ std::min(m_Config.fecGroupSize, MAX_FEC_DATA) };
+			const uint8_t parity{ std::clamp<uint8_t>(m_Config.fecParityCount, 1, std::min(MAX_FEC_PARITY, group)) };
+			if (group != m_Config.fecGroupSize || parity != m_Config.fecParityCount)
+				std::print("FEC group {} with {} parity out of range, using {} with {}.\n",
+					m_Config.fecGroupSize, m_Config.fecParityCount, group, parity);
+			m_Config.fecGroupSize = group;
+			m_Config.fecParityCount = parity;
+		}
+
+		std::random_device entropy{};
+		for (auto& word : m_CookieKey) word = (static_cast<uint64_t>(entropy()) << 32) | entropy();
+
+		m_SendBuffer.reserve(PACKET_MTU);
 		m_CommandBuffer.reserve(35);
 		m_PendingConnections.reserve((m_MaxSessions > 32 ? 32 : m_MaxSessions));
 	}
 
 	void NetworkManager::maintainSessions()
 	{
-		auto now = getTime();
+		auto now = m_Clock.refresh();
 
-		// Retry Pending Connections
-		for (auto it{ m_PendingConnections.begin() }; it != m_PendingConnections.end();) {
-			if (now - it->lastSendTime > m_Policy.resendDelay) {
-				// Resend Connection Request
-				it->retryCount++;
-				if (it->retryCount > m_Policy.maxRetries) {
-					it = m_PendingConnections.erase(it);
-					continue;
+		// Detect timeout, Submit Heartbeats, Retry Pending Connections
+		m_Timers.advance(now, [&](const SessionTimer& timer) { handleTimer(timer, now); });
+
+		// Replicate World, every live endpoint gets its payload each tick
+		m_Sessions.forEach([&](uint32_t id, Session& sesh) {
+			auto live = [](const Endpoint& ep) {
+				return ep.state != ConnectionState::DROPPING && ep.state != ConnectionState::TIMEOUT;
+			};
+			if (live(sesh.endpoint[EP_RELIABLE])) {
+				// Queue payload, everything framed this tick leaves packed together
+				queueReliablePayload(id, sesh);
+				flushMessages(id, sesh);
+				// One socket has no unreliable endpoint, its payload goes out alongside the reliable one
+				if (m_Config.singleSocket) queueUnreliablePayload(id, sesh);
+
+				// Delayed ack, a payload queued above already took the pending acks
+				auto& reliable{ sesh.states[CH_RELIABLE] };
+				if (reliable.ackDueTime
+					&& (now >= reliable.ackDueTime || reliable.unackedCount >= m_Policy.ackThreshold)) {
+					m_CommandBuffer.emplace_back(m_Sessions.handle(id), id,
+						static_cast<PacketFlags>(RELIABLE | ACKNOWLEDGEMENT));
 				}
-				m_CommandBuffer.emplace_back(it->addr, it->port,
-					static_cast<PacketFlags>(CONNECTION_REQUEST | RELIABLE));
-				it->lastSendTime = now;
 			}
-			it++;
+			if (!m_Config.singleSocket && live(sesh.endpoint[EP_UNRELIABLE])) queueUnreliablePayload(id, sesh);
+		});
+	}
+	void NetworkManager::handleTimer(const SessionTimer& timer, uint64_t now)
+	{
+		if (timer.kind == SessionTimer::RETRY) {
+			const uint32_t index{ m_PendingIndex.find(timer.address) };
+			if (index == FlatIndex<uint64_t>::NONE) return; // connected or given up
+			auto& pending{ m_PendingConnections[index] };
+			if (now - pending.lastSendTime <= m_Policy.resendDelay) {
+				m_Timers.schedule(pending.lastSendTime + m_Policy.resendDelay + 1, timer);
+				return;
+			}
+			// Resend Connection Request
+			pending.retryCount++;
+			if (pending.retryCount > m_Policy.maxRetries) {
+				erasePending(pending);
+				return;
+			}
+			m_CommandBuffer.emplace_back(pending.addr, pending.port,
+				static_cast<PacketFlags>(CONNECTION_REQUEST | RELIABLE));
+			pending.lastSendTime = now;
+			m_Timers.schedule(now + m_Policy.resendDelay + 1, timer);
+			return;
 		}
 
-		// Detect timeout
-		// Replicate World
-		// Submit Heartbeats
-		for (auto& [id, sesh] : m_Sessions) {
-			auto handleEndpoint = [&](auto& ep, PacketFlags flag) {
-				if (ep.state == ConnectionState::DROPPING || ep.state == ConnectionState::TIMEOUT)
-					return;
+		Session* pSesh{ m_Sessions.get(timer.sesh) };
+		if (!pSesh) return; // erased, its timers lapse
+		Session& sesh{ *pSesh };
+		auto& reliable{ sesh.endpoint[EP_RELIABLE] };
+		auto& unreliable{ sesh.endpoint[endpointIndex(EP_UNRELIABLE)] };
+		Endpoint& ep{ sesh.endpoint[timer.endpoint] };
+
+		switch (timer.kind) {
+		case SessionTimer::HEARTBEAT:
+			if (ep.state == ConnectionState::DROPPING) return;
+			if (ep.state == ConnectionState::TIMEOUT) {
+				m_Timers.schedule(now + m_Policy.heartbeat, timer); // silent until revived
+				return;
+			}
+			if (now - ep.lastSentTime > m_Policy.heartbeat) {
+				m_CommandBuffer.emplace_back(timer.sesh, timer.sessionID,
+					static_cast<PacketFlags>((timer.endpoint == EP_RELIABLE ? RELIABLE : UNRELIABLE) | HEARTBEAT));
+				m_Timers.schedule(now + m_Policy.heartbeat + 1, timer);
+			}
+			else m_Timers.schedule(ep.lastSentTime + m_Policy.heartbeat + 1, timer);
+			break;
 
-				// Timeout
-				if (now - ep.lastRecvTime > m_Policy.disconnect) {
-					ep.state = ConnectionState::TIMEOUT;
-					return;
-				}
+		case SessionTimer::TIMEOUT:
+			if (ep.state == ConnectionState::DROPPING) return;
+			if (now - ep.lastRecvTime <= m_Policy.disconnect) {
+				m_Timers.schedule(ep.lastRecvTime + m_Policy.disconnect + 1, timer);
+				return;
+			}
+			ep.state = ConnectionState::TIMEOUT;
+			if (reliable.state == ConnectionState::TIMEOUT && unreliable.state == ConnectionState::TIMEOUT) {
+				dropSession(timer.sessionID, sesh);
+				return;
+			}
+			// Still watched, a resumed handshake revives it
+			m_Timers.schedule(now + m_Policy.disconnect, timer);
+			break;
 
-				// Queue payload
-				if (flag == RELIABLE) {
-					queueReliablePayload(id, sesh);
-				}
-				// else queueUnreliablePayload(id, sesh);
-				 
-				// Heartbeat
-				if (now - ep.lastSentTime > m_Policy.heartbeat) {
-					m_CommandBuffer.emplace_back(&sesh, id, 
-						static_cast<PacketFlags>(flag | HEARTBEAT));
-				}
-			};
-			handleEndpoint(sesh.endpoint[EP_RELIABLE], RELIABLE);
-			handleEndpoint(sesh.endpoint[EP_UNRELIABLE], UNRELIABLE);
+		case SessionTimer::GRACE:
+			// Grace period over, Destruct session
+			std::print("Session {} Disconnected!\n", timer.sessionID);
+			m_Sessions.erase(timer.sessionID);
+			break;
+
+		default:
+			break;
+		}
+	}
+	void NetworkManager::dropSession(uint32_t id, Session& sesh)
+	{
+		auto& reliable{ sesh.endpoint[EP_RELIABLE] };
+		if (reliable.state == ConnectionState::DROPPING) return;
+		// Starting Dropping timer, Reconnect not allowed
+		const uint64_t now{ m_Clock.now() };
+		sesh.graceTimer = now;
+		reliable.state = ConnectionState::DROPPING;
+		sesh.endpoint[endpointIndex(EP_UNRELIABLE)].state = ConnectionState::DROPPING;
+		std::print("Session {} is now Dropping!\n", id);
+		m_Timers.schedule(now + m_Policy.disconnect + 1, { .sesh = m_Sessions.handle(id),
+			.sessionID = id, .kind = SessionTimer::GRACE });
+	}
+	void NetworkManager::scheduleSessionTimers(uint32_t id, const Session& sesh)
+	{
+		const SessionHandle handle{ m_Sessions.handle(id) };
+		for (uint8_t endpoint : activeSockets()) {
+			const auto& ep{ sesh.endpoint[endpoint] };
+			m_Timers.schedule(ep.lastSentTime + m_Policy.heartbeat + 1,
+				{ .sesh = handle, .sessionID = id, .endpoint = endpoint, .kind = SessionTimer::HEARTBEAT });
+			m_Timers.schedule(ep.lastRecvTime + m_Policy.disconnect + 1,
+				{ .sesh = handle, .sessionID = id, .endpoint = endpoint, .kind = SessionTimer::TIMEOUT });
 		}
 	}
 	void NetworkManager::opportunisticReceive()
 	{
+		// The ring fd turns readable with completions, sockets otherwise
+		std::array<uint64_t, SOCKET_COUNT> handles{};
+		std::array<PollResult, SOCKET_COUNT> ready{};
+		std::span<const uint64_t> waitOn{};
+		if (m_Ring.isActive()) {
+			handles[0] = m_Ring.getHandle();
+			waitOn = std::span{ handles }.first(1);
+		}
+		else {
+			const auto sockets{ activeSockets() };
+			for (size_t i{}; i < sockets.size(); i++) handles[i] = m_Socks[sockets[i]].getHandle();
+			waitOn = std::span{ handles }.first(sockets.size());
+		}
+
 		while (true) {
-			uint64_t now{ getTime() };
-			if (now >= m_NextTick) return;
-			uint64_t remainingTimeUs = m_NextTick - now;
-			// Skip short Waits, reduce jitter
-			if (remainingTimeUs <= 1500) return;
-
-			// sleep until timeout or wake up if packet / error on sockets
-			PollResult res{ Socket::waitForPackets(static_cast<int32_t>(remainingTimeUs / 1000),
-				m_Socks[0].getHandle(), m_Socks[1].getHandle()) };
-
-			if (res == PollResult::Packet) collectIncoming();
-			else if (res == PollResult::Error) {
+			uint64_t now{ m_Clock.refresh() };
+			if (now + m_Config.spinTailUs >= m_NextTick) return;
+			// Paced packets due
+			if (now >= m_NextPace) {
+				sendBacklog(now);
+				flushSends();
+				continue;
+			}
+			// Budget spent, sockets stay readable, just sleep out the tick
+			if (m_Config.drainReceive && !m_ReceiveBudget) waitOn = {};
+
+			// sleep until timeout, the next paced send, or wake up if packet / error on sockets
+			const uint64_t wake{ std::min(m_NextTick - m_Config.spinTailUs, m_NextPace) };
+			const int64_t timeoutUs{ static_cast<int64_t>(wake - now) };
+			if (!Socket::pollSockets(waitOn, ready, timeoutUs)) continue;
+
+			if (std::ranges::any_of(std::span{ ready }.first(waitOn.size()),
+				[](PollResult res) { return res == PollResult::Error; }))
 				handleError();
+			collectIncoming();
+			// Acks may have opened a window
+			if (!m_Backlogged.empty()) {
+				sendBacklog(m_Clock.refresh());
+				flushSends();
 			}
 		}
 	}
 	void NetworkManager::collectIncoming()
 	{
-		PollResult res{};
-		do {
-			// Reliable
-			res = m_Socks[EP_RELIABLE].poll();
-			if (res == PollResult::Packet) {
-				m_PacketBuffer.clear();
-				PacketInfo info = m_Socks[EP_RELIABLE].receivePacket(m_PacketBuffer);
-				if (m_PacketBuffer.size() != 0) {
-					m_Stats.packetsReceived++;
-					m_Stats.bytesReceived += m_PacketBuffer.size();
-
-					// TODO: Check Against Drop List
-					// Drop Packet if Invalid
-					if (!handleReliablePacket(info)) m_Stats.packetsDropped++;
-				}
-			}
-			if (res == PollResult::Error) {
-				// Handle Error
-				handleError(m_Socks[EP_RELIABLE]);
+		// Arrival time for the batch, handlers read the cached clock
+		m_Clock.refresh();
+		// Packets other workers received for our sessions, already counted by them
+		m_Inbox.drain([this](uint8_t socket, std::span<const std::byte> packet, const PacketInfo& info) {
+			if (handlePacket(socket, packet, info) != PacketResult::Handled) m_Stats.packetsDropped++;
+		});
+
+		if (m_Ring.isActive()) {
+			// Flush task work, then reap every datagram the multishot receives have landed
+			m_Ring.submit();
+			RingPacket packet{};
+			while (m_Ring.nextPacket(packet)) {
+				dispatchDatagram(m_Config.singleSocket ? uint8_t{ EP_RELIABLE } : packet.socketIndex,
+					packet.data, packet.info);
+				m_Ring.release(packet);
 			}
+			const SendFailures failures{ m_Ring.takeSendFailures() };
+			m_Stats.sendsDropped += failures.count;
+			if (failures.worst == SocketError::Fatal) handleError();
+			return;
+		}
 
-		} while (res != PollResult::None);
+		if (m_Config.drainReceive) {
+			drainSockets();
+			return;
+		}
 
-		do {
-			// Unreliable
-			auto res = m_Socks[EP_UNRELIABLE].poll();
-			if (res == PollResult::Packet) {
-				m_PacketBuffer.clear();
-				PacketInfo info = m_Socks[EP_UNRELIABLE].receivePacket(m_PacketBuffer);
-				if (m_PacketBuffer.size() != 0) {
-					m_Stats.packetsReceived++;
-					m_Stats.bytesReceived += m_PacketBuffer.size();
-					// Drop Packet if Invalid
-					if (!handleUnreliablePacket(info)) m_Stats.packetsDropped++;
+		// Reliable first, then Unreliable
+		for (uint8_t socket : activeSockets()) {
+			PollResult res{};
+			do {
+				res = m_Socks[socket].poll();
+				if (res == PollResult::Packet) {
+					// Fill the slab in one batch, handlers read slots in place
+					uint32_t count{ m_Socks[socket].receiveBatch(m_RecvSlab.slots()) };
+					m_Clock.refresh();
+					for (const auto& slot : m_RecvSlab.slots().first(count))
+						dispatchDatagram(socket, ReceiveSlab::view(slot), slot.info);
 				}
+				if (res == PollResult::Error) {
+					// Socket Error
+					handleError(m_Socks[socket]);
+				}
+			} while (res != PollResult::None);
+		}
+	}
+	void NetworkManager::drainSockets()
+	{
+		if (m_ReceiveBudget == 0) return;
+
+		const auto sockets{ activeSockets() };
+		std::array<uint64_t, SOCKET_COUNT> handles{};
+		std::array<PollResult, SOCKET_COUNT> ready{};
+		for (size_t i{}; i < sockets.size(); i++) handles[i] = m_Socks[sockets[i]].getHandle();
+
+		if (!Socket::pollSockets(std::span{ handles }.first(sockets.size()), ready)) return;
+
+		// Reliable first, then Unreliable
+		for (size_t i{}; i < sockets.size(); i++) {
+			const uint8_t socket{ sockets[i] };
+			if (ready[i] == PollResult::Error) {
+				handleError(m_Socks[socket]);
+				continue;
 			}
-			if (res == PollResult::Error) {
-				// Socket Error
-				handleError(m_Socks[EP_UNRELIABLE]); 
+			if (ready[i] != PollResult::Packet) continue;
+
+			while (m_ReceiveBudget) {
+				auto slots{ m_RecvSlab.slots() };
+				if (slots.size() > m_ReceiveBudget) slots = slots.first(m_ReceiveBudget);
+
+				uint32_t count{ m_Socks[socket].receiveBatch(slots) };
+				m_ReceiveBudget -= count;
+				m_Clock.refresh();
+				for (const auto& slot : slots.first(count))
+					dispatchDatagram(socket, ReceiveSlab::view(slot), slot.info);
+				// Short read, socket would block
+				if (count < slots.size()) break;
 			}
-		} while (res != PollResult::None);
+		}
 	}
 	void NetworkManager::queueResends()
 	{
-		auto now = Engine::getTime();
-		for (auto it{ m_ResendBuffer.begin() }; it != m_ResendBuffer.end();) {
-			if (!(m_Sessions.contains(it->sessionID)) 
-				|| (it->resendCount >= m_Policy.maxRetries)
-				|| !(it->sesh->endpoint[EP_RELIABLE].state == ConnectionState::CONNECTED)) {
-				it = m_ResendBuffer.erase(it);
+		auto now = m_Clock.now();
+		while (!m_ResendTimers.empty() && m_ResendTimers.top().deadline <= now) {
+			const ResendTimer timer{ m_ResendTimers.top() };
+			m_ResendTimers.pop();
+
+			Session* pSesh{ m_Sessions.find(timer.sessionID) };
+			if (!pSesh) continue;
+			auto& sesh{ *pSesh };
+			// Acked, released or rescheduled since this entry was pushed
+			PacketDescriptor* packet{ sesh.resend.find(timer.sequenceNum) };
+			if (!packet || packet->deadline != timer.deadline) continue;
+
+			// The first send of a fast retransmit is not a timeout
+			if (!packet->fastRetransmitted || packet->resendCount > 1)
+				sesh.congestion.onTimeout(packet->sequenceNum, sesh.states[CH_RELIABLE].lastSent, m_Policy);
+
+			if (sesh.endpoint[EP_RELIABLE].state != ConnectionState::CONNECTED) {
+				sesh.resend.release(*packet);
 				continue;
 			}
-
-			auto& state = it->sesh->states[CH_RELIABLE];
-			// Check for Ack
-			if (!(it->Acked)) {
-				auto diff = state.lastSent - it->sequenceNum;
-				if (diff >= 32) {
-					it = m_ResendBuffer.erase(it);
-					continue;
-				}
-				it->Acked = ((state.receivedACKField >> diff) & 1ul);
-			}
-			if (it->Acked) {
-				it = m_ResendBuffer.erase(it);
+			// Given up on, its messages and any stream waiting on them would never arrive.
+			// Narrow acks can't reach back past 32, such a packet would resend until maxRetries
+			if (packet->resendCount >= m_Policy.maxRetries
+				|| (!sesh.wideAck && sesh.states[CH_RELIABLE].lastSent - packet->sequenceNum > ACK_FIELD_BITS)) {
+				sesh.resend.release(*packet);
+				dropSession(timer.sessionID, sesh);
 				continue;
 			}
 
-			if ((now - it->lastSendTime) >= m_Policy.resendDelay) {
-				m_CommandBuffer.emplace_back(&(*it), static_cast<PacketFlags>(STATE_LOAD | RELIABLE));
-				it->lastSendTime = now;
-			}
-
-			it++;
+			m_CommandBuffer.emplace_back(packet, static_cast<PacketFlags>(STATE_LOAD | RELIABLE));
+			packet->lastSendTime = now;
+			// RTO backed off per resend, at least 1us out so a zero delay cannot pop forever
+			packet->deadline = now + std::max<uint64_t>(sesh.rtt.timeout(packet->resendCount + 1, m_Policy), 1);
+			m_ResendTimers.push({ packet->deadline, timer.sessionID, timer.sequenceNum });
 		}
 	}
 	void NetworkManager::processCommands()
 	{
 		for (auto& cmd : m_CommandBuffer) {
+			// Sent after the backlog, whose packets may carry the acks
+			if (cmd.type == (RELIABLE | ACKNOWLEDGEMENT)) continue;
 			auto channel{ cmd.type & CHANNEL_MASK };
 			auto type{ cmd.type & TYPE_MASK };
+			// Session commands resolve their handle, the session may be gone since they were queued
+			Session* pSesh{};
+			if (type == CONNECTION_ACCEPT || type == HEARTBEAT) {
+				pSesh = m_Sessions.get(cmd.ep.sesh);
+				if (!pSesh) continue;
+			}
 			if (channel & RELIABLE) {
 				switch (type) {
 				case CONNECTION_REQUEST:
@@ -202,7 +404,7 @@ namespace Carnival::Network {
 
 				case CONNECTION_ACCEPT:
 					CL_CORE_ASSERT(!(cmd.type & FRAGMENT), "Connection accept has fragment bit!");
-					sendAccept(cmd.sessionID, *cmd.ep.sesh);
+					sendAccept(cmd.sessionID, *pSesh);
 					break;
 
 				case CONNECTION_REJECT:
@@ -212,12 +414,15 @@ namespace Carnival::Network {
 
 				case HEARTBEAT:
 					CL_CORE_ASSERT(!(cmd.type & FRAGMENT), "heartbeat has fragment bit!");
-					sendHeartbeat(cmd.sessionID, *cmd.ep.sesh, EP_RELIABLE, CH_RELIABLE);
+					sendHeartbeat(cmd.sessionID, *pSesh, EP_RELIABLE, CH_RELIABLE);
 					break;
 
 				case STATE_LOAD:
 				case EVENT_LOAD:
-					sendReliablePayload(*cmd.ep.descriptor);
+					// Acked between queueResends and now
+					if (!cmd.ep.descriptor->pData) break;
+					if (m_GSOEnabled) m_PayloadBatch.push_back(cmd.ep.descriptor);
+					else sendReliablePayload(*cmd.ep.descriptor);
 					break;
 				default:
 					CL_CORE_ASSERT(false, "Wrong Packet type and channel combo command!");
@@ -228,7 +433,7 @@ namespace Carnival::Network {
 				switch (type) {
 				case HEARTBEAT:
 					CL_CORE_ASSERT(!(cmd.type & FRAGMENT), "heartbeat has fragment bit!");
-					sendHeartbeat(cmd.sessionID, *cmd.ep.sesh, EP_UNRELIABLE, CH_UNRELIABLE);
+					sendHeartbeat(cmd.sessionID, *pSesh, EP_UNRELIABLE, CH_UNRELIABLE);
 					break;
 				}
 			}
@@ -236,46 +441,53 @@ namespace Carnival::Network {
 				// snapshot
 			}
 		}
+		// New packets as far as windows and pacing allow
+		sendBacklog(m_Clock.now());
+		for (auto& cmd : m_CommandBuffer) {
+			// Acks not piggybacked since it was queued
+			if (cmd.type != (RELIABLE | ACKNOWLEDGEMENT)) continue;
+			if (Session* pSesh{ m_Sessions.get(cmd.ep.sesh) }; pSesh && pSesh->states[CH_RELIABLE].ackDueTime)
+				sendAcknowledgement(cmd.sessionID, *pSesh);
+		}
 		m_CommandBuffer.clear();
+		flushSends();
 	}
 
-	void NetworkManager::cleanupSessions()
-	{
-		uint64_t now{ getTime() };
-		for (auto it{ m_Sessions.begin() }; it != m_Sessions.end();) {
-			auto& sesh{ it->second };
-			if (sesh.endpoint[EP_UNRELIABLE].state == ConnectionState::TIMEOUT
-				&& sesh.endpoint[EP_RELIABLE].state == ConnectionState::TIMEOUT) {
-				// Starting Dropping timer for timed out session,
-				// Reconnect not allowed
-				sesh.graceTimer = now;
-				sesh.endpoint[EP_RELIABLE].state = ConnectionState::DROPPING;
-				sesh.endpoint[EP_UNRELIABLE].state = ConnectionState::DROPPING;
-				std::print("Session {} is now Dropping!\n", it->first);
-			}
-			else if (sesh.endpoint[EP_UNRELIABLE].state == ConnectionState::DROPPING
-				&& sesh.endpoint[EP_RELIABLE].state == ConnectionState::DROPPING) {
-				if (now - sesh.graceTimer > m_Policy.disconnect) {
-					// Grace period over, Destruct session
-					std::print("Session {} Disconnected!\n", it->first);
-					it = m_Sessions.erase(it);
-					continue;
-				}
-			}
-			else {
-				std::print("Session {} Is Connected.\n", it->first);
-				std::print("  Sent Seq: {}, Received Seq: {}\n",
-					it->second.states[1].lastSent, it->second.states[1].lastReceived);
-				sesh.graceTimer = 0;
-			}
-			it++;
-		}
+	void NetworkManager::printSessions()
+	{
+		if (m_Sessions.size() > 8) return;
+		m_Sessions.forEach([&](uint32_t id, Session& sesh) {
+			if (sesh.endpoint[EP_RELIABLE].state == ConnectionState::DROPPING) return;
+			std::print("Session {} Is Connected.\n", id);
+			std::print("  Sent Seq: {}, Received Seq: {}\n",
+				sesh.states[1].lastSent, sesh.states[1].lastReceived);
+			std::print("  RTT: {}us, RTO: {}us, Window: {}, Queued: {}\n", sesh.rtt.srtt,
+				sesh.rtt.timeout(1, m_Policy), sesh.congestion.window, sesh.sendQueue.size());
+		});
 	}
 
-	void NetworkManager::run(uint16_t tickRate)
+	void NetworkManager::run(uint16_t tickRate, const ThreadConfig& threadConfig)
 	{
 		CL_CORE_ASSERT(tickRate && ((tickRate & (tickRate - 1)) == 0), "TickRate should be a power of two");
 		CL_CORE_ASSERT(tickRate < 1024, "Windows Timer granularity is 1ms, 1024hz breaks sleep");
+
+		// Published before m_Running, readers wait on isRunning()
+		m_ThreadStatus = applyThreadConfig(threadConfig);
+		if (threadConfig.lockMemory)
+			m_ThreadStatus.memoryLock = lockBuffers() ? SettingState::Applied : SettingState::Failed;
+		if (m_ThreadStatus.affinity != SettingState::NotRequested
+			|| m_ThreadStatus.scheduling != SettingState::NotRequested
+			|| m_ThreadStatus.memoryLock != SettingState::NotRequested) {
+			auto name = [](SettingState state) {
+				switch (state) {
+				case SettingState::Applied: return "applied";
+				case SettingState::Failed: return "failed";
+				default: return "default";
+				}
+			};
+			std::print("Net thread {}: affinity {}, scheduling {}, memory lock {}\n", m_WorkerIndex,
+				name(m_ThreadStatus.affinity), name(m_ThreadStatus.scheduling), name(m_ThreadStatus.memoryLock));
+		}
 		m_Running.test_and_set(std::memory_order::release);
 		m_Running.notify_all();
 
@@ -284,20 +496,35 @@ namespace Carnival::Network {
 		const uint32_t tickDiffUs{ 1'000'000ul >> std::countr_zero(tickRate) };
 		const uint32_t remainder{ 1'000'000ul & (tickRate - 1)};
 		uint32_t frac{};
-		m_NextTick = getTime() + tickDiffUs;
+		m_NextTick = m_Clock.refresh() + tickDiffUs;
 
 		while (!m_ShouldStop.test(std::memory_order::acquire)) {
-			
+			m_ReceiveBudget = m_Config.receiveBudget;
+
 			tickCounter++;
 			tickCounter = tickCounter & (tickRate - 1);
 			if (tickCounter == 0) { // Run once a second
-				std::cout << "\033[2J\033[H" << std::flush;
-				std::print("Net Stats:\n  Packets:\n    Sent: {}\n    Received: {}\n    Dropped: {}\n",
-					m_Stats.packetsSent, m_Stats.packetsReceived, m_Stats.packetsDropped);
-				std::print("  Bytes:\n    Sent: {}\n    Received: {}\n",
-					m_Stats.bytesSent, m_Stats.bytesReceived);
+				publishStats();
+				// A pool prints merged counters from its first worker only
+				if (m_WorkerIndex == 0) {
+					NetworkStats stats{ m_pPool ? m_pPool->getStats() : m_Stats };
+					std::cout << "\033[2J\033[H" << std::flush;
+					std::print("Net Stats:\n  Packets:\n    Sent: {}\n    Received: {}\n    Dropped: {}\n",
+						stats.packetsSent, stats.packetsReceived, stats.packetsDropped);
+					if (stats.sendsDropped) std::print("    Send Failures: {}\n", stats.sendsDropped);
+					std::print("  Bytes:\n    Sent: {}\n    Received: {}\n",
+						stats.bytesSent, stats.bytesReceived);
+					std::print("  Payload Pool: {} / {}\n", stats.payloadSlotsInUse, stats.payloadSlotsTotal);
+					std::print("  Fast Retransmits: {}\n", stats.fastRetransmits);
+					std::print("  Messages:\n    Sent: {}\n    Received: {}\n",
+						stats.messagesSent, stats.messagesReceived);
+					std::print("  FEC Recovered: {}\n", stats.fecRecovered);
+					std::print("  Filtered: {}, Bans: {}\n", stats.packetsFiltered, stats.sourcesBanned);
+					if (m_pPool) std::print("  Workers: {}, Handed Off: {}\n",
+						m_pPool->workerCount(), stats.packetsHandedOff);
+				}
 
-				cleanupSessions();
+				printSessions();
 			}
 
 			maintainSessions();
@@ -305,12 +532,12 @@ namespace Carnival::Network {
 			collectIncoming();
 			processCommands();
 
-			//opportunisticReceive();
-			// Less than 1ms Busy wait
-			uint64_t now = getTime();
+			opportunisticReceive();
+			// Spin the tail, wake-up latency is too coarse for the deadline
+			uint64_t now = m_Clock.refresh();
 			while (now < m_NextTick) {
 				SpinPause();
-				now = getTime();
+				now = m_Clock.refresh();
 			}
 			
 			// Advance Tick
@@ -325,6 +552,7 @@ namespace Carnival::Network {
 				frac -= tickRate;
 			}
 		}
+		publishStats();
 		m_NextTick = 0;
 		m_Running.clear(std::memory_order::release);
 		m_Running.notify_all();
@@ -337,20 +565,64 @@ namespace Carnival::Network {
 		m_ShouldStop.clear(std::memory_order::release);
 	}
 
+	NetworkStats NetworkManager::getStats()
+	{
+		std::lock_guard lock{ m_StatsLock };
+		return m_PublishedStats;
+	}
+	bool NetworkManager::lockBuffers() noexcept
+	{
+		const auto slab{ m_RecvSlab.memory() };
+		bool locked{ lockMemory(slab.data(), slab.size()) };
+		// Reserved for their largest packet in the constructor, never reallocated after
+		locked &= lockMemory(m_SendBuffer.data(), m_SendBuffer.capacity());
+		locked &= lockMemory(m_GSOBuffer.data(), m_GSOBuffer.capacity());
+		// Chunks the pool grows later are locked as they are allocated
+		locked &= m_PayloadPool.lockChunks(lockMemory);
+		if (m_Ring.isActive()) locked &= m_Ring.lockBuffers();
+		return locked;
+	}
+	void NetworkManager::publishStats()
+	{
+		m_Stats.payloadSlotsInUse = m_PayloadPool.inUse();
+		m_Stats.payloadSlotsTotal = m_PayloadPool.capacity();
+		std::lock_guard lock{ m_StatsLock };
+		m_PublishedStats = m_Stats;
+	}
+
 	void NetworkManager::attemptConnect(ipv4_addr addr, uint16_t port)
 	{	
 		m_CommandBuffer.emplace_back(addr,
 			port, static_cast<PacketFlags>(CONNECTION_REQUEST | RELIABLE));
 
+		// Called between ticks, the cached time may be a tick old
+		const uint64_t now{ m_Clock.refresh() };
 		// Prevent duplicate peer creation
-		for (auto& p : m_PendingConnections) {
-			if (p.addr == addr && p.port == port) {
-				p.retryCount++;
-				p.lastSendTime = getTime(); // not actually the time sent but last time requested
-				return;
-			}
+		if (PendingPeer* p{ findPending(addr, port) }) {
+			p->retryCount++;
+			p->lastSendTime = now; // not actually the time sent but last time requested
+			return;
+		}
+		m_PendingIndex.assign(addressKey(addr, port), static_cast<uint32_t>(m_PendingConnections.size()));
+		m_PendingConnections.emplace_back(now, addr, port, 0);
+		m_Timers.schedule(now + m_Policy.resendDelay + 1,
+			{ .address = addressKey(addr, port), .kind = SessionTimer::RETRY });
+	}
+	PendingPeer* NetworkManager::findPending(ipv4_addr addr, uint16_t port) noexcept
+	{
+		const uint32_t index{ m_PendingIndex.find(addressKey(addr, port)) };
+		return index == FlatIndex<uint64_t>::NONE ? nullptr : &m_PendingConnections[index];
+	}
+	void NetworkManager::erasePending(const PendingPeer& peer) noexcept
+	{
+		const uint32_t index{ static_cast<uint32_t>(&peer - m_PendingConnections.data()) };
+		m_PendingIndex.erase(addressKey(peer.addr, peer.port));
+		if (index + 1 != m_PendingConnections.size()) {
+			auto& last{ m_PendingConnections.back() };
+			m_PendingIndex.assign(addressKey(last.addr, last.port), index);
+			m_PendingConnections[index] = last;
 		}
-		m_PendingConnections.emplace_back(getTime(), addr, port, 0);
+		m_PendingConnections.pop_back();
 	}
 
 	// Serialize Packet header into buffer
@@ -358,7 +630,7 @@ namespace Carnival::Network {
 	{
 		auto append = [&](const auto& val) {
 			const std::byte* p = reinterpret_cast<const std::byte*>(&val);
-			m_PacketBuffer.insert(m_PacketBuffer.end(), p, p + sizeof(val));
+			m_SendBuffer.insert(m_SendBuffer.end(), p, p + sizeof(val));
 		};
 		
 		CL_CORE_ASSERT(header.flags, "Header to be written needs flags"); // no validity check
@@ -372,6 +644,8 @@ namespace Carnival::Network {
 		append(header.lastSeqRecv);
 		append(header.sessionID);
 
+		if ((header.flags & WIDE_ACK) != 0)
+			append(header.ackFieldExt);
 		if ((header.flags & FRAGMENT) != 0)
 			append(header.fragLoad);
 	}
@@ -395,16 +669,18 @@ namespace Carnival::Network {
 		append(header.lastSeqRecv);
 		append(header.sessionID);
 
+		if ((header.flags & WIDE_ACK) != 0)
+			append(header.ackFieldExt);
 		if ((header.flags & FRAGMENT) != 0)
 			append(header.fragLoad);
 
 		return cursor;
 	}
 	// Parse header from buffer, validate
-	HeaderInfo NetworkManager::parseHeader()
+	HeaderInfo NetworkManager::parseHeader(std::span<const std::byte> packet)
 	{
-		auto size = m_PacketBuffer.size();
-		auto data = m_PacketBuffer.data();
+		auto size = packet.size();
+		auto data = packet.data();
 
 		if (size < (sizeof(HeaderInfo::protocol) + sizeof(HeaderInfo::flags) +
 			sizeof(PacketHeader::SequenceNumber) + sizeof(PacketHeader::ACKField) +
@@ -434,6 +710,13 @@ namespace Carnival::Network {
 		std::memcpy(&info.sessionID, data + info.offset, sizeof(info.sessionID));
 		info.offset += sizeof(info.sessionID);
 
+		// Check for wide ack bit and copy the extension
+		if (info.flags & WIDE_ACK) {
+			if (size - info.offset < sizeof(info.ackFieldExt)) return {};
+			std::memcpy(info.ackFieldExt.data(), data + info.offset, sizeof(info.ackFieldExt));
+			info.offset += sizeof(info.ackFieldExt);
+		}
+
 		// Check for fragment bit and copy fragment load
 		if (info.flags & FRAGMENT) {
 			if (size - info.offset < sizeof(FragmentLoad)) return {};
@@ -446,9 +729,11 @@ namespace Carnival::Network {
 
 	bool NetworkManager::updateSessionStats(const PacketInfo packet, 
 		const HeaderInfo& header,
-		Endpoint& ep, ChannelState& state)
+		Session& sesh, uint8_t channel, uint8_t endpoint)
 	{
-		const uint64_t now = getTime();
+		const uint64_t now = m_Clock.now();
+		Endpoint& ep{ sesh.endpoint[endpoint] };
+		ChannelState& state{ sesh.states[channel] };
 
 		if (ep.state == ConnectionState::DROPPING)
 			return false;
@@ -458,54 +743,157 @@ namespace Carnival::Network {
 			&& now - ep.lastRecvTime > m_Policy.disconnect)
 			return false;
 
+		// Ack-only packets don't consume a sequence number, their seqNum is not checked or acked
+		const bool ackOnly{ (header.flags & TYPE_MASK) == ACKNOWLEDGEMENT };
+		// Sequence window the acks can span
+		const uint32_t window{ (channel == CH_RELIABLE && sesh.wideAck) ? WIDE_ACK_BITS : ACK_FIELD_BITS };
+
 		// Sequence Must make sense
-		if (header.lastSeqRecv + 32 < state.lastSent ||
+		if (header.lastSeqRecv + window < state.lastSent ||
 			header.lastSeqRecv > state.lastSent) return false;
 		
 		// Too old to care
-		if (header.seqNum + 32 < state.lastReceived) return false;
+		if (!ackOnly && header.seqNum + window < state.lastReceived) return false;
 		
 		// Too far ahead // Desync!
-		if (header.seqNum > state.lastReceived + 32) return false;
+		if (!ackOnly && header.seqNum > state.lastReceived + window) return false;
 
 		uint32_t diff{ state.lastSent - header.lastSeqRecv };
 		// Nat Rebind, update endpoint if peer is validated
 		if (packet.fromAddr != ep.addr || packet.fromPort != ep.port) {
 			// ACK field validation
-			uint32_t mask = (diff == 32) ? UINT32_MAX : ((1 << diff) - 1);
+			uint32_t mask = (diff >= 32) ? UINT32_MAX : ((1u << diff) - 1);
 			if (header.ackField & ~mask) return false;
 			if (state.lastSent != 0 && (header.ackField & mask) == 0) return false;
 
+			if (endpoint == EP_RELIABLE)
+				m_Sessions.rebind(header.sessionID, ep.addr, ep.port, packet.fromAddr, packet.fromPort);
 			ep.addr = packet.fromAddr;
 			ep.port = packet.fromPort;
 			ep.state = ConnectionState::CONNECTED;
 		}
 		
-		if (header.seqNum >= state.lastReceived) {
-			state.sendingAckF <<= header.seqNum - state.lastReceived;
+		if (ackOnly) {}
+		else if (header.seqNum >= state.lastReceived) {
+			// In order arrivals wait for a piggyback, gaps and duplicates ack next tick
+			if (channel == CH_RELIABLE) scheduleAck(state, header.seqNum != state.lastReceived + 1, now);
+			state.sendingAck.shift(header.seqNum - state.lastReceived);
 			state.lastReceived = header.seqNum;
-			state.sendingAckF |= 1ul;
+			state.sendingAck.set(0);
 		}
 		else {
-			state.sendingAckF |= (1 << (state.lastReceived - header.seqNum));
+			const uint32_t age{ state.lastReceived - header.seqNum };
+			if (channel == CH_RELIABLE) scheduleAck(state, true, now);
+			state.sendingAck.set(age);
+			// Beyond the base field, only the extension can report it
+			if (age >= ACK_FIELD_BITS) state.wideAckPending = true;
 		}
 
 		ep.lastRecvTime = now;
 
-		uint32_t peerAckMask = header.ackField << diff;
-		state.receivedACKField |= peerAckMask;
+		if (diff < 32) {
+			uint32_t peerAckMask = header.ackField << diff;
+			state.receivedACKField |= peerAckMask;
+		}
+		// Acked packets leave the ring now, their timers go stale
+		if (channel == CH_RELIABLE) {
+			auto onAck = [&](const PacketDescriptor& packet) {
+				// Karn: a resent packet's ack is ambiguous, sample only single sends
+				if (packet.resendCount == 1)
+					sesh.rtt.sample(static_cast<uint32_t>(now - packet.lastSendTime), m_Policy);
+			};
+			uint32_t acked{ sesh.resend.acknowledge(header.lastSeqRecv, header.ackField, onAck) };
+			if (header.flags & WIDE_ACK) {
+				for (uint32_t word{}; word < header.ackFieldExt.size(); word++)
+					acked += sesh.resend.acknowledge(header.lastSeqRecv - ACK_FIELD_BITS * (word + 1),
+						header.ackFieldExt[word], onAck);
+			}
+			if (acked) sesh.congestion.onAck(acked, window);
+			// Holes with enough newer acks are lost, resend next tick instead of waiting an RTO
+			std::array<uint32_t, WIDE_ACK_BITS / 32> fields{ header.ackField };
+			std::ranges::copy(header.ackFieldExt, fields.begin() + 1);
+			const auto acks{ std::span<const uint32_t>{ fields }.first(header.flags & WIDE_ACK ? fields.size() : 1) };
+			sesh.resend.forEachHole(header.lastSeqRecv, acks, m_Policy.fastRetransmitThreshold,
+				[&](PacketDescriptor& packet) {
+					if (packet.fastRetransmitted || packet.resendCount == 0) return;
+					packet.fastRetransmitted = true;
+					packet.deadline = now;
+					m_Stats.fastRetransmits++;
+					sesh.congestion.onLoss(packet.sequenceNum, sesh.states[CH_RELIABLE].lastSent, m_Policy);
+					m_ResendTimers.push({ now, header.sessionID, packet.sequenceNum });
+				});
+		}
 
 		return true;
 	}
 
-	inline bool NetworkManager::handleReliablePacket(const PacketInfo info)
+	void NetworkManager::dispatchDatagram(uint8_t socket, std::span<const std::byte> data, const PacketInfo info)
 	{
-		HeaderInfo header{ parseHeader() };
-		uint32_t payloadSize{ static_cast<uint32_t>(m_PacketBuffer.size() - header.offset) };
+		const uint64_t segment{ info.segmentSize ? info.segmentSize : data.size() };
+		const uint32_t now{ static_cast<uint32_t>(m_Clock.now()) };
+		for (uint64_t offset{}; offset < data.size(); offset += segment) {
+			auto packet{ data.subspan(offset, std::min(segment, data.size() - offset)) };
+			m_Stats.packetsReceived++;
+			m_Stats.bytesReceived += packet.size();
+
+			// One probe, banned or over-rate sources cost no parse or session lookup
+			if (m_Ingress.active() && !m_Ingress.admit(info.fromAddr, info.fromPort, now)) {
+				m_Stats.packetsFiltered++;
+				continue;
+			}
 
-		if (auto channel{ header.flags & CHANNEL_MASK };
-			channel != RELIABLE) return false;
+			// Session owned by another worker, SO_REUSEPORT hashes flows not sessions
+			if (m_pPool && packet.size() >= SESSION_ID_OFFSET + sizeof(uint32_t)) {
+				uint32_t sessionID{};
+				std::memcpy(&sessionID, packet.data() + SESSION_ID_OFFSET, sizeof(sessionID));
+				if (uint16_t owner{ m_pPool->ownerOf(sessionID) }; sessionID && owner != m_WorkerIndex) {
+					m_pPool->handOff(owner, socket, packet, info);
+					m_Stats.packetsHandedOff++;
+					continue;
+				}
+			}
+
+			const PacketResult result{ handlePacket(socket, packet, info) };
+			if (result == PacketResult::Handled) continue;
+			m_Stats.packetsDropped++;
+			if (result == PacketResult::Malformed && m_Ingress.strike(info.fromAddr, info.fromPort, now))
+				m_Stats.sourcesBanned++;
+		}
+	}
+	PacketResult NetworkManager::handlePacket(uint8_t socket, std::span<const std::byte> packet, const PacketInfo info)
+	{
+		// Drop Packet if Invalid
+		HeaderInfo header{ parseHeader(packet) };
+		if (header.flags == INVALID) return PacketResult::Malformed;
+		auto channel{ header.flags & CHANNEL_MASK };
+		auto type{ header.flags & TYPE_MASK };
+		// Dual sockets pin each channel to its own port
+		if (!m_Config.singleSocket && channel != (socket == EP_RELIABLE ? RELIABLE : UNRELIABLE))
+			return PacketResult::Malformed;
+		// Only reliable payloads are split, a fragmented handshake is never sent
+		if ((header.flags & FRAGMENT) && (channel != RELIABLE || (type != STATE_LOAD && type != EVENT_LOAD)))
+			return PacketResult::Malformed;
+		// Unpadded requests would make the challenge an amplifier
+		if (type == CONNECTION_REQUEST && packet.size() - header.offset < COOKIE_SIZE)
+			return PacketResult::Malformed;
+
+		bool handled{ false };
+		switch (channel) {
+		case RELIABLE:
+			handled = handleReliablePacket(packet, header, info);
+			break;
+		case UNRELIABLE:
+			handled = handleUnreliablePacket(packet, header, info);
+			break;
+		default:
+			break;
+		}
+		return handled ? PacketResult::Handled : PacketResult::Dropped;
+	}
 
+	inline bool NetworkManager::handleReliablePacket(std::span<const std::byte> packet,
+		const HeaderInfo& header, const PacketInfo info)
+	{
 		// switch on flag
 		switch (auto type{ header.flags & TYPE_MASK }; type) {
 		case INVALID:
@@ -513,52 +901,48 @@ namespace Carnival::Network {
 			break;
 
 		case CONNECTION_REQUEST:
-			if (header.flags & FRAGMENT) return false;
-			handleConnectionRequest(info, header);
+			handleConnectionRequest(info, header, packet.subspan(header.offset));
 			break;
 
 		case CONNECTION_ACCEPT:
-			if (header.flags & FRAGMENT) return false;
 			return handleConnectionAccept(info, header);
 			break;
 
 		case CONNECTION_REJECT:
-			if (header.flags & FRAGMENT) return false;
-			return handleConnectionReject(info, header);
+			return handleConnectionReject(info, header, packet.subspan(header.offset));
 			break;
 
 		case HEARTBEAT:
-			if (header.flags & FRAGMENT) return false;
+		case ACKNOWLEDGEMENT: // refreshes the session the same way, minus the sequence
 			return handleHeartbeat(info, header, CH_RELIABLE, EP_RELIABLE);
 			break;
 
 		case EVENT_LOAD:
 		case STATE_LOAD:
-			return handlePayload(info, header, payloadSize, CH_RELIABLE, EP_RELIABLE);
+			return handlePayload(info, header, packet.subspan(header.offset), CH_RELIABLE, EP_RELIABLE);
 		default:
 			return false;
 		}
 
 		return true;
 	}
-	inline bool NetworkManager::handleUnreliablePacket(const PacketInfo info)
+	inline bool NetworkManager::handleUnreliablePacket(std::span<const std::byte> packet,
+		const HeaderInfo& header, const PacketInfo info)
 	{
-		HeaderInfo header{ parseHeader() };
-		uint32_t payloadSize{ static_cast<uint32_t>(m_PacketBuffer.size() - header.offset) };
-
-		if (auto channel{ header.flags & CHANNEL_MASK };
-			channel != UNRELIABLE) return false;
-
 		switch (auto type{ header.flags & TYPE_MASK }; type) {
 		case INVALID:
 			return false;
 			break;
 
 		case HEARTBEAT:
-			if (header.flags & FRAGMENT) return false;
-			return handleHeartbeat(info, header, CH_UNRELIABLE, EP_UNRELIABLE);
+			return handleHeartbeat(info, header, CH_UNRELIABLE, endpointIndex(EP_UNRELIABLE));
 			break;
 
+		case EVENT_LOAD:
+		case STATE_LOAD:
+			return handleUnreliablePayload(info, header, packet.subspan(header.offset),
+				CH_UNRELIABLE, endpointIndex(EP_UNRELIABLE));
+
 		default:
 			return false;
 		}
@@ -568,10 +952,9 @@ namespace Carnival::Network {
 
 	inline bool NetworkManager::handleError()
 	{
-		for (auto& sock : m_Socks) {
-			while (sock.poll() == PollResult::Error) {
-				m_PacketBuffer.clear();
-				if(!handleError(sock)) return false;
+		for (uint8_t socket : activeSockets()) {
+			while (m_Socks[socket].poll() == PollResult::Error) {
+				if(!handleError(m_Socks[socket])) return false;
 			}
 		}
 		return true;
@@ -587,13 +970,15 @@ namespace Carnival::Network {
 	}
 
 	inline void NetworkManager::handleConnectionRequest(const PacketInfo info,
-		const HeaderInfo& header)
+		const HeaderInfo& header, std::span<const std::byte> payload)
 	{
+		CL_CORE_ASSERT(payload.size() >= COOKIE_SIZE, "Unpadded requests are refused in handlePacket");
+
 		// check existing sessions
 		if (header.sessionID != 0) {
-			if (auto it{ m_Sessions.find(header.sessionID) }; it != m_Sessions.end()) {
+			if (Session* pSesh{ m_Sessions.find(header.sessionID) }) {
 				// Resume Existing Session
-				auto& localEndPoint = it->second.endpoint[1];
+				auto& localEndPoint = pSesh->endpoint[1];
 				auto state = localEndPoint.state;
 
 				if (state == ConnectionState::DROPPING) { 
@@ -603,12 +988,11 @@ namespace Carnival::Network {
 				if (localEndPoint.addr == info.fromAddr 
 					&& localEndPoint.port == info.fromPort) {
 					localEndPoint.state = ConnectionState::CONNECTED;
-					acceptConnection(it->first);
+					acceptConnection(header.sessionID);
 					return;
 				}
-				if (updateSessionStats(info, header, 
-					it->second.endpoint[EP_RELIABLE], it->second.states[CH_RELIABLE]))
-					acceptConnection(it->first);
+				if (updateSessionStats(info, header, *pSesh, CH_RELIABLE, EP_RELIABLE))
+					acceptConnection(header.sessionID);
 				else rejectConnection(info.fromAddr, info.fromPort);
 			}
 			else	rejectConnection(info.fromAddr, info.fromPort);
@@ -616,18 +1000,15 @@ namespace Carnival::Network {
 		}
 
 		// Packet session id == 0, 
-		for (auto& [id, sesh] : m_Sessions) {
-			if (sesh.endpoint[EP_RELIABLE].addr == info.fromAddr 
-				&& sesh.endpoint[EP_RELIABLE].port == info.fromPort) {				
-
-				if (sesh.endpoint[EP_RELIABLE].state == ConnectionState::DROPPING) {
-					rejectConnection(info.fromAddr, info.fromPort);
-					return;
-				}
-				sesh.endpoint[EP_RELIABLE].state = ConnectionState::CONNECTED;
-				acceptConnection(id);
+		uint32_t existingID{};
+		if (Session* pSesh{ m_Sessions.find(info.fromAddr, info.fromPort, &existingID) }) {
+			if (pSesh->endpoint[EP_RELIABLE].state == ConnectionState::DROPPING) {
+				rejectConnection(info.fromAddr, info.fromPort);
 				return;
 			}
+			pSesh->endpoint[EP_RELIABLE].state = ConnectionState::CONNECTED;
+			acceptConnection(existingID);
+			return;
 		}
 
 		// check max vs curr sessions
@@ -638,24 +1019,31 @@ namespace Carnival::Network {
 		}
 
 		// check pending connections
-		for (auto it{ m_PendingConnections.begin() }; it != m_PendingConnections.end(); ++it) {
-			if (it->addr == info.fromAddr && it->port == info.fromPort) {
-				uint32_t sessionID{ createSession(*it) };
-				m_PendingConnections.erase(it);
-				acceptConnection(sessionID);
-				return;
-			}
+		if (PendingPeer* pPending{ findPending(info.fromAddr, info.fromPort) }) {
+			uint32_t sessionID{ createSession(*pPending) };
+			erasePending(*pPending);
+			m_Sessions.find(sessionID)->wideAck = (header.flags & WIDE_ACK) && m_Config.wideAcks;
+			acceptConnection(sessionID);
+			return;
+		}
+
+		// Source address unproven until it echoes a cookie, nothing is kept for it before then
+		uint64_t cookie{};
+		std::memcpy(&cookie, payload.data(), sizeof(cookie));
+		if (!validCookie(info.fromAddr, info.fromPort, cookie)) {
+			sendChallenge(info.fromAddr, info.fromPort);
+			return;
 		}
 
 		// create new session
-		// for now just accept
 		PendingPeer peer{
-			.lastSendTime = getTime(),
+			.lastSendTime = m_Clock.now(),
 			.addr = info.fromAddr,
 			.port = info.fromPort,
 			.retryCount = 1,
 		};
 		uint32_t ID{ createSession(peer) };
+		m_Sessions.find(ID)->wideAck = (header.flags & WIDE_ACK) && m_Config.wideAcks;
 		acceptConnection(ID);
 	}
 	inline bool NetworkManager::handleConnectionAccept(const PacketInfo packet,
@@ -663,38 +1051,43 @@ namespace Carnival::Network {
 	{
 		if (!header.sessionID) return false;
 
-		if (auto it = m_Sessions.find(header.sessionID); it != m_Sessions.end()) {
-			auto& sesh{ it->second };
-			if (sesh.endpoint[EP_RELIABLE].state == ConnectionState::DROPPING) return true;
-			return updateSessionStats(packet, header,
-				sesh.endpoint[EP_RELIABLE], sesh.states[CH_RELIABLE]);
-		}
-
-		for (auto& pending : m_PendingConnections) {
-			if (pending.addr == packet.fromAddr && pending.port == packet.fromPort) {
-				std::print("Peer found! creating session {}\n", header.sessionID);
-				if (createSession(pending, header.sessionID))
-					return true;
-				else { // ID collision
-					std::print("ID Collision when creating session from connectionAccept: {}",
-						header.sessionID);
-					return true;
-				}
+		if (Session* pSesh{ m_Sessions.find(header.sessionID) }) {
+			if (pSesh->endpoint[EP_RELIABLE].state == ConnectionState::DROPPING) return true;
+			return updateSessionStats(packet, header, *pSesh, CH_RELIABLE, EP_RELIABLE);
+		}
+
+		if (PendingPeer* pPending{ findPending(packet.fromAddr, packet.fromPort) }) {
+			std::print("Peer found! creating session {}\n", header.sessionID);
+			if (Session* pSesh{ createSession(*pPending, header.sessionID) }) {
+				// Accept carries the extension only if our offer was taken
+				pSesh->wideAck = (header.flags & WIDE_ACK) && m_Config.wideAcks;
+				return true;
+			}
+			else { // ID collision
+				std::print("ID Collision when creating session from connectionAccept: {}",
+					header.sessionID);
+				return true;
 			}
 		}
 
 		return false;
 	}
 	inline bool NetworkManager::handleConnectionReject(const PacketInfo packet,
-		const HeaderInfo& header)
+		const HeaderInfo& header, std::span<const std::byte> payload)
 	{
-		for (auto it = m_PendingConnections.begin(); it != m_PendingConnections.end(); it++) {
-			if (it->addr == packet.fromAddr && it->port == packet.fromPort) {
-				m_PendingConnections.erase(it);
-				return true;
-			}
+		PendingPeer* pPending{ findPending(packet.fromAddr, packet.fromPort) };
+		if (!pPending) return false;
+		if (payload.size() < COOKIE_SIZE) {
+			erasePending(*pPending);
+			return true;
 		}
-		return false;
+		// Challenge, answer now, a forged one only costs a retry
+		std::memcpy(&pPending->cookie, payload.data(), sizeof(pPending->cookie));
+		pPending->retryCount++;
+		pPending->lastSendTime = m_Clock.now();
+		m_CommandBuffer.emplace_back(packet.fromAddr, packet.fromPort,
+			static_cast<PacketFlags>(CONNECTION_REQUEST | RELIABLE));
+		return true;
 	}
 	// refresh session timing, keep alive
 	inline bool NetworkManager::handleHeartbeat(const PacketInfo packet,
@@ -702,10 +1095,9 @@ namespace Carnival::Network {
 		uint8_t Channel, uint8_t endpoint) noexcept {
 
 		if (header.sessionID == 0) return false;
-		if (auto it{ m_Sessions.find(header.sessionID) }; it != m_Sessions.end()) {
-			if (it->second.endpoint[endpoint].state == ConnectionState::DROPPING) return true;
-			return updateSessionStats(packet, header,
-				it->second.endpoint[endpoint], it->second.states[Channel]);
+		if (Session* pSesh{ m_Sessions.find(header.sessionID) }) {
+			if (pSesh->endpoint[endpoint].state == ConnectionState::DROPPING) return true;
+			return updateSessionStats(packet, header, *pSesh, Channel, endpoint);
 		}
 		return false;
 	}
@@ -714,27 +1106,30 @@ namespace Carnival::Network {
 	{
 		while (true) {
 			uint32_t id{ generateSessionID() };
+			// Keep IDs on this worker so later packets route back here
+			if (m_pPool && m_pPool->ownerOf(id) != m_WorkerIndex) continue;
 			if (!createSession(info, id)) continue;
 			return id;
 		}
 	}
-	bool NetworkManager::createSession(const PendingPeer& info, uint32_t key)
+	Session* NetworkManager::createSession(const PendingPeer& info, uint32_t key)
 	{
-		auto [it, inserted] = m_Sessions.try_emplace(key, Session{});
-		if (!inserted) return false;
-		Session& sesh = it->second;
+		Session* pSesh{ m_Sessions.emplace(key, info.addr, info.port) };
+		if (!pSesh) return nullptr;
+		Session& sesh = *pSesh;
 		auto& reliable_end = sesh.endpoint[EP_RELIABLE];
 
-		reliable_end.addr = info.addr;
-		reliable_end.port = info.port;
 		reliable_end.state = ConnectionState::CONNECTED;
-		reliable_end.lastRecvTime = getTime();
+		reliable_end.lastRecvTime = m_Clock.now();
 		reliable_end.lastSentTime = info.lastSendTime;
 
 		sesh.endpoint[EP_UNRELIABLE].state = ConnectionState::CONNECTING;
-		sesh.endpoint[EP_UNRELIABLE].lastRecvTime = getTime();
+		sesh.endpoint[EP_UNRELIABLE].lastRecvTime = m_Clock.now();
+		sesh.outbox.reserve(PACKET_PAYLOAD);
+		sesh.congestion.window = m_Policy.initialWindow;
+		scheduleSessionTimers(key, sesh);
 
-		return true;
+		return pSesh;
 	}
 
 	void NetworkManager::queueReliablePayload(uint32_t id, Session& sesh)
@@ -742,50 +1137,307 @@ namespace Carnival::Network {
 		CL_CORE_ASSERT(sesh.endpoint[CH_RELIABLE].state == ConnectionState::CONNECTED,
 			"Endpoint must be connected before sending");
 
-		auto& context{ m_pWorld->getShardContext(id) };
+		auto& context{ m_pWorld->getShardContext(m_WorkerIndex) };
 		// copy contextData, etc.
-		// size of data to be replicated, derive from world later
-		uint32_t sizeOfData{ 4 };
-
-		uint32_t sizeofHeader{ 21 }; // packet Header wire size
-		if (sizeOfData > PACKET_MTU) sizeofHeader += 6; // FragmentPayloadSize
+		// data to be replicated, derive from world later
+		uint32_t data{ sesh.states[CH_RELIABLE].lastSent + 1 };
+		queueMessage(id, sesh, STATE_LOAD, std::as_bytes(std::span{ &data, 1 }));
+	}
+	bool NetworkManager::queueMessage(uint32_t id, Session& sesh, PacketFlags type, std::span<const std::byte> message,
+		uint8_t stream)
+	{
+		if (stream != UNORDERED && stream >= ORDERED_STREAMS) return false;
+		const bool ordered{ stream != UNORDERED };
+		const uint32_t leadSize{ MessagePrefix::SIZE + (ordered ? MessagePrefix::ORDERED_SIZE : 0) };
+		const uint64_t frameSize{ leadSize + message.size() };
+		// Refused before a sequence is taken, a numbered message that never leaves stalls its stream
+		if ((frameSize + FRAGMENT_PAYLOAD - 1) / FRAGMENT_PAYLOAD > MAX_FRAGMENTS) return false;
+		// Backpressure, a peer that stops acking can't make the queue grow without bound
+		const uint64_t packets{ frameSize > PACKET_PAYLOAD
+			? (frameSize + FRAGMENT_PAYLOAD - 1) / FRAGMENT_PAYLOAD + !sesh.outbox.empty()
+			: sesh.outbox.size() + frameSize > PACKET_PAYLOAD };
+		if (sesh.sendQueue.size() + packets > m_Policy.maxQueued) return false;
+
+		// The receiver holds at most ORDERED_WINDOW early messages, wait for acks past that
+		if (ordered) {
+			auto& sending{ sesh.streams[stream] };
+			if (static_cast<uint16_t>(sending.nextSend - sending.sendFloor) >= ORDERED_WINDOW) {
+				sending.sendFloor = oldestUnacked(sesh, stream);
+				if (static_cast<uint16_t>(sending.nextSend - sending.sendFloor) >= ORDERED_WINDOW) return false;
+			}
+		}
 
-		auto packetSize{ sizeofHeader + sizeOfData };
-		auto packet{ new std::byte[packetSize]() };
+		// Prefix, then stream and sequence when ordered
+		std::array<std::byte, MessagePrefix::SIZE + MessagePrefix::ORDERED_SIZE> lead{};
+		uint8_t frameType{ type };
+		OrderedMarks marks{};
+		if (ordered) {
+			const uint16_t sequence{ sesh.streams[stream].nextSend++ };
+			frameType |= MessagePrefix::ORDERED;
+			lead[MessagePrefix::SIZE] = static_cast<std::byte>(stream);
+			std::memcpy(lead.data() + MessagePrefix::SIZE + 1, &sequence, sizeof(sequence));
+			marks.mark(stream, sequence);
+		}
 
-		sesh.states[CH_RELIABLE].receivedACKField <<= 1;
-		HeaderInfo info{
-			.protocol = HEADER_VERSION,
-			.seqNum{sesh.states[CH_RELIABLE].lastSent++},
-			.ackField{sesh.states[CH_RELIABLE].sendingAckF},
-			.lastSeqRecv{sesh.states[CH_RELIABLE].lastReceived},
-			.sessionID{id},
-			.flags = static_cast<PacketFlags>(STATE_LOAD | RELIABLE),
+		if (frameSize > PACKET_PAYLOAD) {
+			// Packets leave in message order, what the receiver may hold stays within a resend window
+			flushMessages(id, sesh);
+			const uint16_t prefix{ MessagePrefix::pack(frameType, 0) };
+			std::memcpy(lead.data(), &prefix, sizeof(prefix));
+			queueFragments(id, sesh, type, std::span{ lead }.first(leadSize), message, marks);
+			return true;
+		}
+		if (sesh.outbox.size() + frameSize > PACKET_PAYLOAD)
+			flushMessages(id, sesh);
+		if (ordered) sesh.outboxOrdered.mark(stream, marks.first[stream]);
+
+		const uint16_t prefix{ MessagePrefix::pack(frameType, static_cast<uint32_t>(frameSize - MessagePrefix::SIZE)) };
+		std::memcpy(lead.data(), &prefix, sizeof(prefix));
+		sesh.outbox.insert(sesh.outbox.end(), lead.begin(), lead.begin() + leadSize);
+		sesh.outbox.insert(sesh.outbox.end(), message.begin(), message.end());
+		m_Stats.messagesSent++;
+		return true;
+	}
+	void NetworkManager::flushMessages(uint32_t id, Session& sesh)
+	{
+		// A full queue keeps the outbox, queueMessage refuses what wouldn't fit alongside it
+		if (sesh.outbox.empty() || sesh.sendQueue.size() >= m_Policy.maxQueued) return;
+		// Packet type is nominal, each message carries its own
+		queueReliablePacket(id, sesh, STATE_LOAD, {}, {}, sesh.outbox, sesh.outboxOrdered);
+		sesh.outbox.clear();
+		sesh.outboxOrdered = {};
+	}
+	uint16_t NetworkManager::oldestUnacked(const Session& sesh, uint8_t stream) const noexcept
+	{
+		// Everything before nextSend when nothing is outstanding
+		const uint16_t nextSend{ sesh.streams[stream].nextSend };
+		uint16_t oldest{ nextSend };
+		auto visit = [&](const OrderedMarks& marks) {
+			if (!(marks.streams & (1u << stream))) return;
+			if (static_cast<uint16_t>(nextSend - marks.first[stream]) > static_cast<uint16_t>(nextSend - oldest))
+				oldest = marks.first[stream];
 		};
-		uint64_t cursor{ writeHeader(packet, info) };
-		
+		visit(sesh.outboxOrdered);
+		for (const auto& queued : sesh.sendQueue) visit(queued.ordered);
+		sesh.resend.forEach([&](const PacketDescriptor& packet) { visit(packet.ordered); });
+		return oldest;
+	}
+	void NetworkManager::queueFragments(uint32_t id, Session& sesh, PacketFlags type,
+		std::span<const std::byte> lead, std::span<const std::byte> message, const OrderedMarks& ordered)
+	{
+		const uint64_t total{ lead.size() + message.size() };
+		const uint64_t count{ (total + FRAGMENT_PAYLOAD - 1) / FRAGMENT_PAYLOAD };
+		CL_CORE_ASSERT(count <= MAX_FRAGMENTS, "Reliable payload exceeds the fragment batch limit");
+
+		// Each fragment is its own reliable packet, a loss resends only that fragment
+		FragmentLoad fragment{
+			.batchNumber{ sesh.states[CH_RELIABLE].batchNumber++ },
+			.FRAGMENT_COUNT{ static_cast<uint16_t>(count) },
+		};
+		// Lead is a few bytes, it always ends inside the first fragment
+		for (uint64_t offset{}; offset < total; offset += FRAGMENT_PAYLOAD) {
+			const uint64_t end{ std::min<uint64_t>(offset + FRAGMENT_PAYLOAD, total) };
+			const uint64_t bodyStart{ std::max<uint64_t>(offset, lead.size()) - lead.size() };
+			queueReliablePacket(id, sesh, static_cast<PacketFlags>(type | FRAGMENT), fragment,
+				offset ? std::span<const std::byte>{} : lead,
+				message.subspan(bodyStart, end - lead.size() - bodyStart), ordered);
+			fragment.fragmentIndex++;
+		}
+		m_Stats.messagesSent++;
+	}
+	void NetworkManager::queueReliablePacket(uint32_t id, Session& sesh, PacketFlags flags, const FragmentLoad& fragment,
+		std::span<const std::byte> lead, std::span<const std::byte> payload, const OrderedMarks& ordered)
+	{
+		CL_CORE_ASSERT(MAX_HEADER_SIZE + lead.size() + payload.size() <= PACKET_MTU, "Reliable packet exceeds the MTU");
+		QueuedPacket& queued{ sesh.sendQueue.emplace_back(
+			PoolBuffer{ m_PayloadPool.acquire(), PoolDeleter{ &m_PayloadPool } },
+			lead.size() + payload.size(), fragment, flags, ordered) };
+
 		// Copy Data
-		uint32_t data{ sesh.states[CH_RELIABLE].lastSent };
-		std::memcpy(packet + cursor, &data, 4);
-		cursor += 4;
+		if (!lead.empty()) std::memcpy(queued.pData.get(), lead.data(), lead.size());
+		std::memcpy(queued.pData.get() + lead.size(), payload.data(), payload.size());
+
+		if (!sesh.backlogged) {
+			sesh.backlogged = true;
+			m_Backlogged.push_back(id);
+		}
+	}
+	void NetworkManager::queueUnreliablePayload(uint32_t id, Session& sesh)
+	{
+		// Dual sockets learn the peer's unreliable address from its first packet there
+		if (!sesh.endpoint[endpointIndex(EP_UNRELIABLE)].port) return;
+
+		// data to be replicated, derive from world later
+		uint32_t data{ sesh.states[CH_UNRELIABLE].lastSent + 1 };
+		sendUnreliablePayload(id, sesh, CH_UNRELIABLE, STATE_LOAD, std::as_bytes(std::span{ &data, 1 }));
+	}
+	void NetworkManager::sendUnreliablePayload(uint32_t id, Session& sesh, uint8_t channel, PacketFlags type,
+		std::span<const std::byte> body)
+	{
+		CL_CORE_ASSERT(channel != CH_RELIABLE, "Reliable payloads go through the send queue");
+		CL_CORE_ASSERT(body.size() <= UNRELIABLE_PAYLOAD, "Unreliable payload exceeds the MTU");
+
+		auto send = [&](const FecLoad& load, std::span<const std::byte> lead, std::span<const std::byte> data) {
+			m_SendBuffer.clear();
+			HeaderInfo info{
+				.protocol{ HEADER_VERSION },
+				.seqNum{ sesh.states[channel].lastSent++ },
+				.sessionID{ id },
+				.flags{ static_cast<PacketFlags>(type | channelFlag(channel)) },
+			};
+			fillAcks(info, sesh, channel);
+			writeHeader(info);
+			const std::byte* pGroup{ reinterpret_cast<const std::byte*>(&load.group) };
+			m_SendBuffer.insert(m_SendBuffer.end(), pGroup, pGroup + sizeof(load.group));
+			m_SendBuffer.push_back(static_cast<std::byte>(load.index));
+			m_SendBuffer.push_back(static_cast<std::byte>(load.dataCount));
+			m_SendBuffer.push_back(static_cast<std::byte>(load.parityCount));
+			m_SendBuffer.insert(m_SendBuffer.end(), lead.begin(), lead.end());
+			m_SendBuffer.insert(m_SendBuffer.end(), data.begin(), data.end());
+			sendUnreliable(sesh.endpoint[endpointIndex(EP_UNRELIABLE)]);
+		};
 
-		m_ResendBuffer.emplace_back(packet, cursor, &sesh, info.seqNum, info.sessionID);
+		const uint8_t dataCount{ m_Config.fecGroupSize };
+		const uint8_t parityCount{ m_Config.fecParityCount };
+		if (!dataCount) {
+			send({}, {}, body);
+			return;
+		}
+		auto& pFec{ sesh.fec[channel] };
+		if (!pFec) pFec = std::make_unique<FecState>();
+		FecState& fec{ *pFec };
+
+		if (fec.nextIndex == 0) fec.send.reset(fec.nextGroup, dataCount, parityCount);
+		send({ fec.nextGroup, fec.nextIndex, dataCount, parityCount }, {}, body);
+		fec.send.classes[fec.nextIndex % parityCount].add(static_cast<uint16_t>(body.size()), type, body);
+		if (++fec.nextIndex < dataCount) return;
+
+		// Group complete, one parity packet per interleave class
+		for (uint8_t i{}; i < parityCount; i++) {
+			const auto& parity{ fec.send.classes[i] };
+			std::array<std::byte, FecLoad::PARITY_SIZE> lead{};
+			std::memcpy(lead.data(), &parity.length, sizeof(parity.length));
+			lead[sizeof(parity.length)] = static_cast<std::byte>(parity.type);
+			send({ fec.nextGroup, static_cast<uint8_t>(dataCount + i), dataCount, parityCount },
+				lead, std::span{ parity.bytes }.first(parity.extent));
+		}
+		fec.nextIndex = 0;
+		fec.nextGroup++;
+	}
+	void NetworkManager::sendBacklog(uint64_t now)
+	{
+		m_NextPace = UINT64_MAX;
+		for (size_t i{}; i < m_Backlogged.size();) {
+			if (Session* pSesh{ m_Sessions.find(m_Backlogged[i]) }) {
+				sendQueued(m_Backlogged[i], *pSesh, now);
+				if (!pSesh->sendQueue.empty()) {
+					i++;
+					continue;
+				}
+				pSesh->backlogged = false;
+			}
+			m_Backlogged[i] = m_Backlogged.back();
+			m_Backlogged.pop_back();
+		}
 	}
+	void NetworkManager::sendQueued(uint32_t id, Session& sesh, uint64_t now)
+	{
+		auto& queue{ sesh.sendQueue };
+		if (sesh.endpoint[EP_RELIABLE].state != ConnectionState::CONNECTED) {
+			queue.clear();
+			return;
+		}
+
+		auto& cc{ sesh.congestion };
+		auto& state{ sesh.states[CH_RELIABLE] };
+		// Past the peer's ack reach the oldest packet in flight could never be acked
+		const uint32_t reach{ sesh.wideAck ? WIDE_ACK_BITS : ACK_FIELD_BITS };
+		const uint64_t rate{ cc.paceRate(sesh.rtt.srtt) };
+		while (!queue.empty()) {
+			// Window full, acks reopen it
+			if (sesh.resend.inFlight() >= std::min(cc.window, reach)
+				|| sesh.resend.occupied(state.lastSent) || sesh.resend.find(state.lastSent - reach)) return;
+			if (!cc.canSend(now, rate, m_Policy.pacingBurst)) {
+				m_NextPace = std::min(m_NextPace, cc.nextSendTime(now, rate));
+				return;
+			}
 
-	// Construct header, Send over Correct socket
+			auto& queued{ queue.front() };
+			state.receivedACKField <<= 1;
+			HeaderInfo info{
+				.protocol = HEADER_VERSION,
+				.seqNum{state.lastSent++},
+				.sessionID{id},
+				.fragLoad{queued.fragment},
+				.flags = static_cast<PacketFlags>(queued.flags | RELIABLE),
+			};
+			fillAcks(info, sesh, CH_RELIABLE);
+
+			// Payload was written from the start of the slot, slide it past the header
+			uint64_t headerSize{ HEADER_SIZE };
+			if (info.flags & WIDE_ACK) headerSize += sizeof(info.ackFieldExt);
+			if (info.flags & FRAGMENT) headerSize += sizeof(info.fragLoad);
+			std::memmove(queued.pData.get() + headerSize, queued.pData.get(), queued.size);
+			writeHeader(queued.pData.get(), info);
+
+			auto& stored{ sesh.resend.insert({ std::move(queued.pData), headerSize + queued.size,
+				&sesh, info.seqNum, info.sessionID }) };
+			stored.ordered = queued.ordered;
+			queue.pop_front();
+			stored.deadline = now + std::max<uint64_t>(sesh.rtt.timeout(1, m_Policy), 1);
+			m_ResendTimers.push({ stored.deadline, id, stored.sequenceNum });
+			cc.paceCredit -= static_cast<int64_t>(stored.size);
+
+			if (m_GSOEnabled) m_PayloadBatch.push_back(&stored);
+			else sendReliablePayload(stored);
+		}
+	}
+	void NetworkManager::flushSends()
+	{
+		if (!m_PayloadBatch.empty()) sendPayloadBatch();
+		// Everything queued goes out in one submission
+		if (m_Ring.isActive()) m_Ring.submit();
+	}
+	inline void NetworkManager::fillAcks(HeaderInfo& info, Session& sesh, uint8_t channel, bool forceWide) noexcept
+	{
+		auto& state{ sesh.states[channel] };
+		info.ackField = state.sendingAck.words[0];
+		info.lastSeqRecv = state.lastReceived;
+		// Extension only when the base field can't cover what changed since the last report
+		if (sesh.wideAck && channel == CH_RELIABLE &&
+			(forceWide || state.wideAckPending || state.lastReceived - state.ackReported >= ACK_FIELD_BITS)) {
+			info.flags = static_cast<PacketFlags>(info.flags | WIDE_ACK);
+			std::copy(state.sendingAck.words.begin() + 1, state.sendingAck.words.end(), info.ackFieldExt.begin());
+			state.wideAckPending = false;
+		}
+		state.ackReported = state.lastReceived;
+		state.ackDueTime = 0;
+		state.unackedCount = 0;
+	}
+	inline void NetworkManager::scheduleAck(ChannelState& state, bool immediate, uint64_t now) noexcept
+	{
+		const uint64_t due{ immediate ? now : now + m_Policy.ackDelay };
+		if (!state.ackDueTime || due < state.ackDueTime) state.ackDueTime = due;
+		state.unackedCount++;
+	}
 	inline void NetworkManager::sendRequest(ipv4_addr addr, uint16_t port) noexcept
 	{
-		m_PacketBuffer.clear();
+		m_SendBuffer.clear();
 		HeaderInfo info{
 			.protocol = HEADER_VERSION,
-			.flags = static_cast<PacketFlags>(CONNECTION_REQUEST | RELIABLE),
+			.flags = static_cast<PacketFlags>(CONNECTION_REQUEST | RELIABLE |
+				(m_Config.wideAcks ? WIDE_ACK : 0)), // offer wide acks, the accept settles it
 		};
 		writeHeader(info);
+		const PendingPeer* pPending{ findPending(addr, port) };
+		const uint64_t cookie{ pPending ? pPending->cookie : 0 };
+		const std::byte* pCookie{ reinterpret_cast<const std::byte*>(&cookie) };
+		m_SendBuffer.insert(m_SendBuffer.end(), pCookie, pCookie + sizeof(cookie));
 		sendReliable(addr, port);
 	}
 	inline void NetworkManager::sendAccept(uint32_t sessionID, Session& sesh) noexcept
 	{
-		m_PacketBuffer.clear();
+		m_SendBuffer.clear();
 
 		CL_CORE_ASSERT(sesh.endpoint[1].state == ConnectionState::CONNECTED, 
 			"Endpoint must be connected before sending");
@@ -793,47 +1445,93 @@ namespace Carnival::Network {
 		HeaderInfo info{
 			.protocol{ HEADER_VERSION },
 			.seqNum{sesh.states[CH_RELIABLE].lastSent++},
-			.ackField{sesh.states[CH_RELIABLE].sendingAckF},
-			.lastSeqRecv{sesh.states[CH_RELIABLE].lastReceived},
 			.sessionID{sessionID},
 			.flags = static_cast<PacketFlags>(CONNECTION_ACCEPT | RELIABLE),
 		};
+		// A wide accept tells the requester the offer was taken
+		fillAcks(info, sesh, CH_RELIABLE, sesh.wideAck);
 		writeHeader(info);
 		sendReliable(sesh.endpoint[1]);
 	}
 	inline void NetworkManager::sendReject(ipv4_addr addr, uint16_t port) noexcept
 	{
-		m_PacketBuffer.clear();
+		m_SendBuffer.clear();
+		HeaderInfo info{
+			.protocol = HEADER_VERSION,
+			.flags = static_cast<PacketFlags>(CONNECTION_REJECT | RELIABLE),
+		};
+		writeHeader(info);
+		sendReliable(addr, port);
+	}
+	inline void NetworkManager::sendChallenge(ipv4_addr addr, uint16_t port) noexcept
+	{
+		m_SendBuffer.clear();
 		HeaderInfo info{
 			.protocol = HEADER_VERSION,
 			.flags = static_cast<PacketFlags>(CONNECTION_REJECT | RELIABLE),
 		};
 		writeHeader(info);
+		const uint64_t cookie{ makeCookie(addr, port, m_Clock.now() / m_Policy.cookieLifetime) };
+		const std::byte* pCookie{ reinterpret_cast<const std::byte*>(&cookie) };
+		m_SendBuffer.insert(m_SendBuffer.end(), pCookie, pCookie + sizeof(cookie));
 		sendReliable(addr, port);
 	}
+	uint64_t NetworkManager::makeCookie(ipv4_addr addr, uint16_t port, uint64_t bucket) const noexcept
+	{
+		const std::array<uint64_t, 2> words{ addressKey(addr, port), bucket };
+		// Never 0, that is the empty cookie slot
+		return utils::siphash24(m_CookieKey[0], m_CookieKey[1], words) | 1;
+	}
+	bool NetworkManager::validCookie(ipv4_addr addr, uint16_t port, uint64_t cookie) const noexcept
+	{
+		if (!cookie) return false;
+		// Current bucket, or the previous one for a cookie issued just before it turned
+		const uint64_t bucket{ m_Clock.now() / m_Policy.cookieLifetime };
+		return cookie == makeCookie(addr, port, bucket) || (bucket && cookie == makeCookie(addr, port, bucket - 1));
+	}
 	inline void NetworkManager::sendHeartbeat(uint32_t sessionID, Session& sesh,
 		uint8_t ep, uint8_t ch) noexcept
 	{
-		m_PacketBuffer.clear();
+		m_SendBuffer.clear();
 		HeaderInfo info{
 			.protocol{ HEADER_VERSION },
 			.seqNum{sesh.states[ch].lastSent++},
-			.ackField{sesh.states[ch].sendingAckF},
-			.lastSeqRecv{sesh.states[ch].lastReceived},
 			.sessionID{sessionID},
 			.flags{ static_cast<PacketFlags>(HEARTBEAT | (1 << (ch + 3))) },
 		};
+		fillAcks(info, sesh, ch);
 		writeHeader(info);
 		// pick socket
 		if (ep) sendReliable(sesh.endpoint[ep]);
-		else sendUnreliable(sesh.endpoint[ep]);
+		else sendUnreliable(sesh.endpoint[endpointIndex(ep)]);
 	}
 
 
+	inline bool NetworkManager::transmit(uint8_t socket, const void* pData, uint64_t size,
+		ipv4_addr addr, uint16_t port) noexcept
+	{
+		socket = endpointIndex(socket);
+		const uint8_t ringIndex{ m_Config.singleSocket ? uint8_t{} : socket };
+		if (m_Ring.isActive() && m_Ring.queueSend(ringIndex, pData, size, addr, port)) return true;
+		return m_Socks[socket].sendPacket(pData, size, addr, port);
+	}
+	inline void NetworkManager::sendAcknowledgement(uint32_t sessionID, Session& sesh) noexcept
+	{
+		m_SendBuffer.clear();
+		HeaderInfo info{
+			.protocol{ HEADER_VERSION },
+			.seqNum{ sesh.states[CH_RELIABLE].lastSent }, // next sequence, not consumed
+			.sessionID{ sessionID },
+			.flags = static_cast<PacketFlags>(ACKNOWLEDGEMENT | RELIABLE),
+		};
+		fillAcks(info, sesh, CH_RELIABLE);
+		writeHeader(info);
+		sendReliable(sesh.endpoint[EP_RELIABLE]);
+	}
 	inline bool NetworkManager::sendReliable(ipv4_addr addr, uint16_t port) noexcept
 	{
-		if (auto res{ m_Socks[1].sendPacket(m_PacketBuffer, addr, port) }; res) {
-			m_Stats.bytesSent += m_PacketBuffer.size();
+		if (auto res{ transmit(EP_RELIABLE, m_SendBuffer.data(), m_SendBuffer.size(), addr, port) }; res) {
+			m_Stats.bytesSent += m_SendBuffer.size();
 			m_Stats.packetsSent++;
 
 			return true;
@@ -842,10 +1540,10 @@ namespace Carnival::Network {
 	}
 	inline bool NetworkManager::sendReliable(Endpoint& ep) noexcept
 	{
-		if (auto res{ m_Socks[1].sendPacket(m_PacketBuffer, ep.addr, ep.port) }; res) {
-			m_Stats.bytesSent += m_PacketBuffer.size();
+		if (auto res{ transmit(EP_RELIABLE, m_SendBuffer.data(), m_SendBuffer.size(), ep.addr, ep.port) }; res) {
+			m_Stats.bytesSent += m_SendBuffer.size();
 			m_Stats.packetsSent++;
-			ep.lastSentTime = getTime();
+			ep.lastSentTime = m_Clock.now();
 			return true;
 		}
 		return false;
@@ -854,22 +1552,78 @@ namespace Carnival::Network {
 	inline bool NetworkManager::sendReliablePayload(PacketDescriptor& packet) noexcept {
 		CL_CORE_ASSERT(packet.pData.get() && packet.size, "Packet must have data and size");
 
-		auto res{ m_Socks[EP_RELIABLE].sendPacket(packet.pData.get(), packet.size,
+		auto res{ transmit(EP_RELIABLE, packet.pData.get(), packet.size,
 			packet.sesh->endpoint[EP_RELIABLE].addr, packet.sesh->endpoint[EP_RELIABLE].port) };
 		if (res) {
 			packet.resendCount++;
 			m_Stats.bytesSent += packet.size;
 			m_Stats.packetsSent++;
-			packet.sesh->endpoint[EP_RELIABLE].lastSentTime = Engine::getTime();
+			packet.lastSendTime = m_Clock.now();
+			packet.sesh->endpoint[EP_RELIABLE].lastSentTime = packet.lastSendTime;
 			return true;
 		}
 		return false;
 	}
 
+	void NetworkManager::sendPayloadBatch()
+	{
+		// Group by session, order within a session is free on the unordered channel
+		std::stable_sort(m_PayloadBatch.begin(), m_PayloadBatch.end(),
+			[](const PacketDescriptor* a, const PacketDescriptor* b) { return a->sesh < b->sesh; });
+
+		for (size_t first{}; first < m_PayloadBatch.size();) {
+			Session* sesh{ m_PayloadBatch[first]->sesh };
+			const uint64_t segment{ m_PayloadBatch[first]->size };
+
+			// Run of equal-sized packets to one peer, a single shorter packet may close it
+			size_t last{ first + 1 };
+			uint64_t total{ segment };
+			while (last < m_PayloadBatch.size() && last - first < GSO_MAX_SEGMENTS) {
+				const auto* next{ m_PayloadBatch[last] };
+				if (next->sesh != sesh || next->size > segment || total + next->size > MAX_UDP_PAYLOAD) break;
+				total += next->size;
+				last++;
+				if (next->size < segment) break;
+			}
+
+			SocketError res{ SocketError::Fatal };
+			auto& ep{ sesh->endpoint[EP_RELIABLE] };
+			if (m_GSOEnabled && last - first > 1) {
+				m_GSOBuffer.clear();
+				for (size_t i{ first }; i < last; i++) {
+					const auto* packet{ m_PayloadBatch[i] };
+					m_GSOBuffer.insert(m_GSOBuffer.end(), packet->pData.get(), packet->pData.get() + packet->size);
+				}
+				res = m_Socks[EP_RELIABLE].sendSegmented(m_GSOBuffer.data(), m_GSOBuffer.size(),
+					static_cast<uint16_t>(segment), ep.addr, ep.port);
+				if (res == SocketError::Fatal) {
+					std::print("UDP segmentation offload refused, sending datagrams individually.\n");
+					m_GSOEnabled = false;
+				}
+			}
+
+			if (res == SocketError::None) {
+				const uint64_t now{ m_Clock.now() };
+				for (size_t i{ first }; i < last; i++) {
+					m_PayloadBatch[i]->resendCount++;
+					m_PayloadBatch[i]->lastSendTime = now;
+					m_Stats.bytesSent += m_PayloadBatch[i]->size;
+					m_Stats.packetsSent++;
+				}
+				ep.lastSentTime = now;
+			}
+			else {
+				for (size_t i{ first }; i < last; i++) sendReliablePayload(*m_PayloadBatch[i]);
+			}
+			first = last;
+		}
+		m_PayloadBatch.clear();
+	}
+
 	inline bool NetworkManager::sendUnreliable(ipv4_addr addr, uint16_t port) noexcept
 	{
-		if (auto res{ m_Socks[0].sendPacket(m_PacketBuffer, addr, port) }; res) {
-			m_Stats.bytesSent += m_PacketBuffer.size();
+		if (auto res{ transmit(EP_UNRELIABLE, m_SendBuffer.data(), m_SendBuffer.size(), addr, port) }; res) {
+			m_Stats.bytesSent += m_SendBuffer.size();
 			m_Stats.packetsSent++;
 
 			return true;
@@ -878,10 +1632,10 @@ namespace Carnival::Network {
 	}
 	inline bool NetworkManager::sendUnreliable(Endpoint& ep) noexcept
 	{
-		if (auto res{ m_Socks[0].sendPacket(m_PacketBuffer, ep.addr, ep.port) }; res) {
-			m_Stats.bytesSent += m_PacketBuffer.size();
+		if (auto res{ transmit(EP_UNRELIABLE, m_SendBuffer.data(), m_SendBuffer.size(), ep.addr, ep.port) }; res) {
+			m_Stats.bytesSent += m_SendBuffer.size();
 			m_Stats.packetsSent++;
-			ep.lastSentTime = getTime();
+			ep.lastSentTime = m_Clock.now();
 			return true;
 		}
 		return false;
@@ -889,19 +1643,190 @@ namespace Carnival::Network {
 
 
 	bool NetworkManager::handlePayload(PacketInfo info, const HeaderInfo& header,
-		const uint64_t payloadSize,
+		std::span<const std::byte> payload,
 		uint8_t Channel, uint8_t endpoint)
 	{
-		if (auto it = m_Sessions.find(header.sessionID); it != m_Sessions.end()) {
-			if (it->second.endpoint[endpoint].state == ConnectionState::DROPPING) return true;
-			updateSessionStats(info, header, it->second.endpoint[endpoint], it->second.states[Channel]);
-			uint32_t load{};
-			std::memcpy(&load, m_PacketBuffer.data() + header.offset, 4);
-			//std::print("Received number: {}\n", load);
+		if (Session* pSesh{ m_Sessions.find(header.sessionID) }) {
+			if (pSesh->endpoint[endpoint].state == ConnectionState::DROPPING) return true;
+			// Out of window or unproven, nothing in it is delivered
+			if (!updateSessionStats(info, header, *pSesh, Channel, endpoint)) return false;
+			if (header.flags & FRAGMENT) {
+				if (Channel != CH_RELIABLE) return false;
+				// A batch is one frame, its body runs to the end
+				FragmentAssembly* pBatch{ reassemble(*pSesh, header.fragLoad, payload) };
+				if (!pBatch) return true; // rest of the batch pending, or a duplicate
+				const auto frame{ pBatch->view() };
+				uint16_t prefix{};
+				bool handled{ false };
+				if (frame.size() >= sizeof(prefix)) {
+					std::memcpy(&prefix, frame.data(), sizeof(prefix));
+					handled = handleFrame(header.sessionID, *pSesh, MessagePrefix::type(prefix), frame.subspan(sizeof(prefix)));
+				}
+				pBatch->release();
+				return handled;
+			}
+			// Framed messages back to back
+			while (!payload.empty()) {
+				uint16_t prefix{};
+				if (payload.size() < sizeof(prefix)) return false;
+				std::memcpy(&prefix, payload.data(), sizeof(prefix));
+				const uint16_t length{ MessagePrefix::length(prefix) };
+				if (payload.size() - sizeof(prefix) < length) return false;
+				if (!handleFrame(header.sessionID, *pSesh, MessagePrefix::type(prefix),
+					payload.subspan(sizeof(prefix), length)))
+					return false;
+				payload = payload.subspan(sizeof(prefix) + length);
+			}
 			return true;
 		}
 		return false;
 	}
+	inline bool NetworkManager::handleUnreliablePayload(PacketInfo info, const HeaderInfo& header,
+		std::span<const std::byte> payload,
+		uint8_t Channel, uint8_t endpoint)
+	{
+		Session* pSesh{ m_Sessions.find(header.sessionID) };
+		if (!pSesh) return false;
+		Session& sesh{ *pSesh };
+		if (sesh.endpoint[endpoint].state == ConnectionState::DROPPING) return true;
+		if (!updateSessionStats(info, header, sesh, Channel, endpoint)) return false;
+
+		FecLoad load{};
+		if (payload.size() < FecLoad::SIZE) return false;
+		std::memcpy(&load.group, payload.data(), sizeof(load.group));
+		load.index = static_cast<uint8_t>(payload[2]);
+		load.dataCount = static_cast<uint8_t>(payload[3]);
+		load.parityCount = static_cast<uint8_t>(payload[4]);
+		const auto body{ payload.subspan(FecLoad::SIZE) };
+		const uint8_t type{ static_cast<uint8_t>(header.flags & TYPE_MASK) };
+
+		if (!load.dataCount) return handleMessage(type, body);
+		if (load.dataCount > MAX_FEC_DATA || !load.parityCount || load.parityCount > MAX_FEC_PARITY
+			|| load.parityCount > load.dataCount || load.index >= load.dataCount + load.parityCount) return false;
+
+		// The sender decides on FEC, the receive side follows
+		auto& pFec{ sesh.fec[Channel] };
+		if (!pFec) pFec = std::make_unique<FecState>();
+		return handleFec(*pFec, load, type, body);
+	}
+	bool NetworkManager::handleFec(FecState& fec, const FecLoad& load, uint8_t type, std::span<const std::byte> body)
+	{
+		const bool parity{ load.index >= load.dataCount };
+		uint16_t length{ static_cast<uint16_t>(body.size()) };
+		uint8_t coveredType{ type };
+		if (parity) {
+			if (body.size() < FecLoad::PARITY_SIZE) return false;
+			std::memcpy(&length, body.data(), sizeof(length));
+			coveredType = static_cast<uint8_t>(body[sizeof(length)]);
+			body = body.subspan(FecLoad::PARITY_SIZE);
+		}
+		if (body.size() > UNRELIABLE_PAYLOAD) return false;
+
+		FecGroup& group{ fec.receive[load.group & 1] };
+		if (!group.active || group.group != load.group) {
+			// Older than the group holding its slot, past helping, data still counts
+			if (group.active && static_cast<int16_t>(load.group - group.group) < 0)
+				return parity || handleMessage(type, body);
+			group.reset(load.group, load.dataCount, load.parityCount);
+		}
+		if (group.dataCount != load.dataCount || group.parityCount != load.parityCount) return false;
+		const uint32_t bit{ 1u << load.index };
+		if (group.received & bit) return true; // duplicate, or data already rebuilt
+		group.received |= bit;
+
+		const uint8_t parityClass{ static_cast<uint8_t>(parity
+			? load.index - load.dataCount : load.index % load.parityCount) };
+		auto& accumulator{ group.classes[parityClass] };
+		accumulator.add(length, coveredType, body);
+		bool handled{ parity || handleMessage(type, body) };
+
+		// Everything else in the class XORed out, the accumulator holds the missing packet
+		if (const int32_t missing{ group.recoverable(parityClass) }; missing >= 0) {
+			group.received |= 1u << missing;
+			if (accumulator.length > UNRELIABLE_PAYLOAD) return false;
+			m_Stats.fecRecovered++;
+			handled &= handleMessage(accumulator.type, std::span{ accumulator.bytes }.first(accumulator.length));
+		}
+		return handled;
+	}
+	inline bool NetworkManager::handleFrame(uint32_t id, Session& sesh, uint8_t frameType,
+		std::span<const std::byte> body)
+	{
+		if (!(frameType & MessagePrefix::ORDERED)) return handleMessage(frameType, body);
+
+		uint16_t sequence{};
+		if (body.size() < MessagePrefix::ORDERED_SIZE) return false;
+		const uint8_t streamIndex{ static_cast<uint8_t>(body[0]) };
+		if (streamIndex >= ORDERED_STREAMS) return false;
+		std::memcpy(&sequence, body.data() + 1, sizeof(sequence));
+		const uint8_t type{ static_cast<uint8_t>(frameType & ~MessagePrefix::ORDERED) };
+		const auto message{ body.subspan(MessagePrefix::ORDERED_SIZE) };
+
+		auto& stream{ sesh.streams[streamIndex] };
+		const int16_t ahead{ static_cast<int16_t>(sequence - stream.nextDeliver) };
+		if (ahead < 0) return true; // resent duplicate, already delivered
+		if (ahead > 0) {
+			// Further than a well-behaved sender gets, holding it would let the peer pin memory
+			if (ahead >= ORDERED_WINDOW || sesh.heldBytes + message.size() > MAX_HELD_BYTES) {
+				dropSession(id, sesh);
+				return false;
+			}
+			sesh.heldBytes += static_cast<uint32_t>(stream.hold(sequence, type, message));
+			return true;
+		}
+
+		bool handled{ handleMessage(type, message) };
+		stream.nextDeliver++;
+		// The hole just closed, release what queued up behind it
+		while (auto* pHeld{ stream.next() }) {
+			handled &= handleMessage(pHeld->type, pHeld->data);
+			sesh.heldBytes -= static_cast<uint32_t>(pHeld->data.size());
+			stream.release(*pHeld);
+			stream.nextDeliver++;
+		}
+		return handled;
+	}
+	inline bool NetworkManager::handleMessage(uint8_t, std::span<const std::byte> message)
+	{
+		m_Stats.messagesReceived++;
+		uint32_t load{};
+		if (message.size() < sizeof(load)) return false;
+		std::memcpy(&load, message.data(), sizeof(load));
+		//std::print("Received number: {}\n", load);
+		return true;
+	}
+	FragmentAssembly* NetworkManager::reassemble(Session& sesh, const FragmentLoad& fragment,
+		std::span<const std::byte> payload) noexcept
+	{
+		const auto& [batch, count, index] { fragment };
+		if (count < 2 || count > MAX_FRAGMENTS || index >= count) return nullptr;
+		// Only the last fragment may be short, so the offset follows from the index
+		if (payload.empty() || payload.size() > FRAGMENT_PAYLOAD
+			|| (index != count - 1 && payload.size() != FRAGMENT_PAYLOAD)) return nullptr;
+		if (sesh.completedBatches.contains(batch)) return nullptr;
+
+		FragmentAssembly* pAssembly{};
+		for (auto& slot : sesh.reassembly) {
+			if (slot.count && slot.batchNumber == batch) {
+				pAssembly = &slot;
+				break;
+			}
+		}
+		if (!pAssembly) {
+			// Unused or finished slot first, else evict the batch furthest behind
+			auto age = [&](const FragmentAssembly& slot) {
+				if (!slot.count || slot.complete()) return UINT32_MAX;
+				return static_cast<uint32_t>(static_cast<uint16_t>(batch - slot.batchNumber));
+			};
+			pAssembly = &*std::ranges::max_element(sesh.reassembly, {}, age);
+			pAssembly->reset(batch, count);
+		}
+		auto& assembly{ *pAssembly };
+		if (assembly.count != count || assembly.complete()) return nullptr;
+		if (!assembly.add(index, payload) || !assembly.complete()) return nullptr;
+		sesh.completedBatches.insert(batch);
+		return &assembly;
+	}
 
 	/*
 	void NetworkManager::sendSnapshot(ipv4_addr addr, uint16_t port)
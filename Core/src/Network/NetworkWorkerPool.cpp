@@ -0,0 +1,84 @@
+#include <src/CNMpch.hpp>
+
+#include <CNM/NetworkWorkerPool.h>
+#include <ECS/World.h>
+
+namespace Carnival::Network {
+	NetworkWorkerPool::NetworkWorkerPool(ECS::World* pWorld,
+		const SocketData& relSockData, const SocketData& urelSockData,
+		uint16_t maxSessions, uint16_t workerCount, const NetworkConfig& config)
+	{
+		CL_CORE_ASSERT(workerCount != 0, "Pool needs at least one worker");
+#ifndef CL_Platform_Linux
+		// No load-balanced port sharing, a second socket would never receive
+		workerCount = 1;
+#endif
+		SocketData rel{ relSockData };
+		SocketData urel{ urelSockData };
+		if (workerCount > 1) {
+			rel.status = static_cast<SocketStatus>(rel.status | SocketStatus::REUSEPORT);
+			urel.status = static_cast<SocketStatus>(urel.status | SocketStatus::REUSEPORT);
+		}
+		const uint16_t sessionShare{ static_cast<uint16_t>((maxSessions + workerCount - 1) / workerCount) };
+
+		m_Workers.reserve(workerCount);
+		for (uint16_t i{}; i < workerCount; i++) {
+			auto& worker{ m_Workers.emplace_back(std::make_unique<NetworkManager>(pWorld,
+				rel, urel, sessionShare, config)) };
+			worker->m_pPool = this;
+			worker->m_WorkerIndex = i;
+
+			if (i == 0 && workerCount > 1) {
+				const bool shared{ std::ranges::all_of(worker->activeSockets(),
+					[&](uint8_t socket) { return worker->m_Socks[socket].isReusePort(); }) };
+				if (!shared) {
+					std::print("SO_REUSEPORT refused, running a single network worker.\n");
+					worker->m_MaxSessions = maxSessions;
+					break;
+				}
+				// Ephemeral ports resolve on the first bind, the other workers join them
+				rel.InPort = worker->getPort(EP_RELIABLE);
+				urel.InPort = worker->getPort(EP_UNRELIABLE);
+			}
+		}
+		// A replication context per worker, none of them share mutable state
+		if (pWorld) pWorld->setShardCount(static_cast<uint16_t>(m_Workers.size()));
+	}
+	NetworkWorkerPool::~NetworkWorkerPool()
+	{
+		stop();
+	}
+
+	void NetworkWorkerPool::start(uint16_t tickRate, const ThreadConfig& threadConfig)
+	{
+		CL_CORE_ASSERT(m_Threads.empty(), "Pool already running");
+		const bool pinEach{ static_cast<uint64_t>(std::popcount(threadConfig.affinityMask)) >= m_Workers.size() };
+		uint64_t remaining{ threadConfig.affinityMask };
+
+		m_Threads.reserve(m_Workers.size());
+		for (auto& worker : m_Workers) {
+			ThreadConfig config{ threadConfig };
+			if (pinEach) {
+				// Lowest remaining CPU
+				config.affinityMask = remaining & (~remaining + 1);
+				remaining &= remaining - 1;
+			}
+			m_Threads.emplace_back([pWorker = worker.get(), tickRate, config]() {
+				pWorker->run(tickRate, config);
+			});
+		}
+	}
+	void NetworkWorkerPool::stop()
+	{
+		if (m_Threads.empty()) return;
+		for (auto& worker : m_Workers) worker->stop();
+		m_Threads.clear(); // joins
+	}
+
+	NetworkStats NetworkWorkerPool::getStats()
+	{
+		NetworkStats total{};
+		for (auto& worker : m_Workers) total += worker->getStats();
+		return total;
+	}
+}
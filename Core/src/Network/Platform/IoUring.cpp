@@ -0,0 +1,416 @@
+#include <src/CNMpch.hpp>
+
+#include <include/CNM/macros.h>
+#include <include/CNM/IoUring.h>
+#include <include/CNM/ThreadConfig.h>
+
+#ifdef CL_Platform_Linux
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace {
+	constexpr uint32_t RING_ENTRIES{ 512 };
+	constexpr uint32_t RECV_BUFFER_COUNT{ 512 }; // power of two, shared by every socket
+	constexpr uint32_t RECV_BUFFER_SIZE{ 2048 }; // recvmsg_out + sockaddr + MTU
+	// GRO receives may coalesce up to 64KB, fewer but larger buffers
+	constexpr uint32_t GRO_BUFFER_COUNT{ 64 };
+	constexpr uint32_t GRO_BUFFER_SIZE{ 72 * 1024 }; // recvmsg_out + sockaddr + cmsg + GRO_MAX_SIZE
+	constexpr uint32_t SEND_SLOT_COUNT{ RING_ENTRIES / 2 };
+	constexpr uint16_t BUFFER_GROUP{ 0 };
+
+	// user_data layout: [tag:8 | socket:8 | slot:48]
+	constexpr uint64_t TAG_RECV{ 1 };
+	constexpr uint64_t TAG_SEND{ 2 };
+	constexpr uint64_t packUserData(uint64_t tag, uint64_t socket, uint64_t slot) {
+		return (tag << 56) | (socket << 48) | slot;
+	}
+	constexpr uint64_t getTag(uint64_t data) { return data >> 56; }
+	constexpr uint8_t getSocket(uint64_t data) { return static_cast<uint8_t>(data >> 48); }
+	constexpr uint64_t getSlot(uint64_t data) { return data & ((1ull << 48) - 1); }
+
+	inline int sysSetup(uint32_t entries, io_uring_params* params) noexcept {
+		return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+	}
+	inline int sysEnter(int fd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags) noexcept {
+		return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+	}
+	inline int sysRegister(int fd, uint32_t op, void* arg, uint32_t count) noexcept {
+		return static_cast<int>(syscall(__NR_io_uring_register, fd, op, arg, count));
+	}
+
+	// Errno of a failed send completion, classified as the socket send paths do
+	inline Carnival::Network::SocketError classifySend(int err) noexcept {
+		using Carnival::Network::SocketError;
+		switch (err) {
+		case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+		case EWOULDBLOCK:
+#endif
+		case EINTR:
+		case ENOBUFS:
+		case EMSGSIZE:
+			return SocketError::Transient;
+		case ECONNREFUSED:
+		case EHOSTUNREACH:
+		case ENETUNREACH:
+			return SocketError::Remote;
+		default:
+			return SocketError::Fatal;
+		}
+	}
+
+	// Walk control messages copied into a provided buffer, 0 if not coalesced
+	inline uint16_t readGROSize(const std::byte* control, uint32_t length) noexcept {
+		uint32_t cursor{};
+		while (cursor + sizeof(cmsghdr) <= length) {
+			cmsghdr cmsg{};
+			std::memcpy(&cmsg, control + cursor, sizeof(cmsg));
+			if (cmsg.cmsg_len < sizeof(cmsghdr)) break;
+			if (cmsg.cmsg_level == SOL_UDP && cmsg.cmsg_type == UDP_GRO) {
+				int size{};
+				std::memcpy(&size, control + cursor + CMSG_LEN(0), sizeof(size));
+				return static_cast<uint16_t>(size);
+			}
+			cursor += static_cast<uint32_t>(CMSG_ALIGN(cmsg.cmsg_len));
+		}
+		return 0;
+	}
+
+	// Ring indices are shared with the kernel
+	template<typename T>
+	inline T loadAcquire(T* p) noexcept { return std::atomic_ref<T>{ *p }.load(std::memory_order::acquire); }
+	template<typename T>
+	inline void storeRelease(T* p, T v) noexcept { std::atomic_ref<T>{ *p }.store(v, std::memory_order::release); }
+}
+
+namespace Carnival::Network {
+	struct IoUring::Ring {
+		struct SendOp {
+			msghdr		header{};
+			iovec		vector{};
+			sockaddr_in	to{};
+			std::byte	data[PACKET_MTU]{};
+		};
+
+		int fd{ -1 };
+		// Submission queue
+		void*		sqRing{ MAP_FAILED };
+		size_t		sqRingSize{};
+		uint32_t*	sqHead{};
+		uint32_t*	sqTail{};
+		uint32_t*	sqArray{};
+		uint32_t	sqMask{};
+		io_uring_sqe* sqes{ static_cast<io_uring_sqe*>(MAP_FAILED) };
+		size_t		sqesSize{};
+		uint32_t	sqLocalTail{};
+		uint32_t	pending{};
+		// Completion queue
+		void*		cqRing{ MAP_FAILED };
+		size_t		cqRingSize{};
+		uint32_t*	cqHead{};
+		uint32_t*	cqTail{};
+		uint32_t	cqMask{};
+		io_uring_cqe* cqes{};
+		// Provided receive buffers, indexed directly: io_uring_buf_ring's flex array
+		// is offset by an empty struct when compiled as C++. Tail overlays bufs[0].resv
+		io_uring_buf* bufRing{ static_cast<io_uring_buf*>(MAP_FAILED) };
+		std::byte*	recvBuffers{ static_cast<std::byte*>(MAP_FAILED) };
+		uint32_t	bufCount{ RECV_BUFFER_COUNT };
+		uint32_t	bufSize{ RECV_BUFFER_SIZE };
+		uint16_t	bufTail{};
+		bool		bufRegistered{ false };
+
+		std::array<int, SOCKET_COUNT>		sockets{};
+		std::array<msghdr, SOCKET_COUNT>	recvTemplates{};
+		uint8_t socketCount{};
+
+		std::unique_ptr<SendOp[]>	sendOps;
+		std::vector<uint16_t>		freeSends;
+		SendFailures				sendFailures{};
+
+		~Ring() {
+			if (bufRegistered) {
+				io_uring_buf_reg reg{};
+				reg.bgid = BUFFER_GROUP;
+				sysRegister(fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+			}
+			// Tear the ring down first, in-flight receives may still target the buffers
+			if (fd >= 0) close(fd);
+			if (recvBuffers != MAP_FAILED) munmap(recvBuffers, static_cast<size_t>(bufCount) * bufSize);
+			if (bufRing != MAP_FAILED) munmap(bufRing, bufCount * sizeof(io_uring_buf));
+			if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+			if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+			if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+		}
+
+		io_uring_sqe* getSQE() noexcept {
+			if (sqLocalTail - loadAcquire(sqHead) >= sqMask + 1) {
+				// Queue full, flush before taking another entry
+				if (!flush(0)) return nullptr;
+				if (sqLocalTail - loadAcquire(sqHead) >= sqMask + 1) return nullptr;
+			}
+			uint32_t idx{ sqLocalTail & sqMask };
+			io_uring_sqe* sqe{ &sqes[idx] };
+			std::memset(sqe, 0, sizeof(io_uring_sqe));
+			sqArray[idx] = idx;
+			sqLocalTail++;
+			pending++;
+			return sqe;
+		}
+		bool flush(uint32_t flags) noexcept {
+			storeRelease(sqTail, sqLocalTail);
+			if (pending == 0 && !(flags & IORING_ENTER_GETEVENTS)) return true;
+			int ret = sysEnter(fd, pending, 0, flags);
+			if (ret < 0) return errno == EINTR || errno == EAGAIN || errno == EBUSY;
+			pending -= std::min<uint32_t>(pending, static_cast<uint32_t>(ret));
+			return true;
+		}
+		bool armReceive(uint8_t socket) noexcept {
+			io_uring_sqe* sqe{ getSQE() };
+			if (!sqe) return false;
+			sqe->opcode = IORING_OP_RECVMSG;
+			sqe->fd = sockets[socket];
+			sqe->addr = reinterpret_cast<uint64_t>(&recvTemplates[socket]);
+			sqe->len = 1;
+			sqe->ioprio = IORING_RECV_MULTISHOT;
+			sqe->flags = IOSQE_BUFFER_SELECT;
+			sqe->buf_group = BUFFER_GROUP;
+			sqe->user_data = packUserData(TAG_RECV, socket, 0);
+			return true;
+		}
+		void provideBuffer(uint16_t bid) noexcept {
+			io_uring_buf& buf{ bufRing[bufTail & (bufCount - 1)] };
+			buf.addr = reinterpret_cast<uint64_t>(recvBuffers + static_cast<uint64_t>(bid) * bufSize);
+			buf.len = bufSize;
+			buf.bid = bid;
+			bufTail++;
+			storeRelease(&bufRing[0].resv, bufTail);
+		}
+	};
+
+	IoUring::IoUring() noexcept {}
+	IoUring::~IoUring() noexcept { shutdown(); }
+
+	bool IoUring::init(std::span<const uint64_t> handles, bool gro) noexcept
+	{
+		CL_CORE_ASSERT(handles.size() <= SOCKET_COUNT, "Too many sockets for ring");
+		shutdown();
+
+		auto ring{ std::make_unique<Ring>() };
+		if (gro) {
+			ring->bufCount = GRO_BUFFER_COUNT;
+			ring->bufSize = GRO_BUFFER_SIZE;
+		}
+		io_uring_params params{};
+		ring->fd = sysSetup(RING_ENTRIES, &params);
+		if (ring->fd < 0) return false;
+
+		// Map queues
+		ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+			ring->sqRingSize = ring->cqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+
+		ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+		if (ring->sqRing == MAP_FAILED) return false;
+		if (params.features & IORING_FEAT_SINGLE_MMAP) ring->cqRing = ring->sqRing;
+		else {
+			ring->cqRing = mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE,
+				MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+			if (ring->cqRing == MAP_FAILED) return false;
+		}
+		ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		ring->sqes = static_cast<io_uring_sqe*>(mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+		if (ring->sqes == MAP_FAILED) return false;
+
+		auto sqBase{ static_cast<std::byte*>(ring->sqRing) };
+		ring->sqHead = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.head);
+		ring->sqTail = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.tail);
+		ring->sqArray = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.array);
+		ring->sqMask = *reinterpret_cast<uint32_t*>(sqBase + params.sq_off.ring_mask);
+		ring->sqLocalTail = *ring->sqTail;
+
+		auto cqBase{ static_cast<std::byte*>(ring->cqRing) };
+		ring->cqHead = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.head);
+		ring->cqTail = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.tail);
+		ring->cqMask = *reinterpret_cast<uint32_t*>(cqBase + params.cq_off.ring_mask);
+		ring->cqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+
+		// Register provided buffer ring, kernel picks a buffer per datagram
+		ring->bufRing = static_cast<io_uring_buf*>(mmap(nullptr, ring->bufCount * sizeof(io_uring_buf),
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+		ring->recvBuffers = static_cast<std::byte*>(mmap(nullptr, static_cast<size_t>(ring->bufCount) * ring->bufSize,
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0));
+		if (ring->bufRing == MAP_FAILED || ring->recvBuffers == MAP_FAILED) return false;
+
+		// Zeroed then filled, the padding fields differ between kernel header versions
+		io_uring_buf_reg reg{};
+		reg.ring_addr = reinterpret_cast<uint64_t>(ring->bufRing);
+		reg.ring_entries = ring->bufCount;
+		reg.bgid = BUFFER_GROUP;
+		if (sysRegister(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) return false;
+		ring->bufRegistered = true;
+		for (uint16_t bid{}; bid < ring->bufCount; bid++) ring->provideBuffer(bid);
+
+		// Send slots
+		ring->sendOps = std::make_unique<Ring::SendOp[]>(SEND_SLOT_COUNT);
+		ring->freeSends.reserve(SEND_SLOT_COUNT);
+		for (uint16_t i{ SEND_SLOT_COUNT }; i > 0; i--) ring->freeSends.push_back(i - 1);
+
+		// Arm one multishot receive per socket
+		for (auto handle : handles) {
+			uint8_t idx{ ring->socketCount++ };
+			ring->sockets[idx] = static_cast<int>(handle);
+			ring->recvTemplates[idx].msg_namelen = sizeof(sockaddr_in);
+			// Kernel only reads the lengths, control data lands in the provided buffer
+			if (gro) ring->recvTemplates[idx].msg_controllen = CMSG_SPACE(sizeof(int));
+			if (!ring->armReceive(idx)) return false;
+		}
+		if (!ring->flush(0)) return false;
+
+		m_Ring = std::move(ring);
+		return true;
+	}
+	void IoUring::shutdown() noexcept
+	{
+		// Closing the ring cancels the multishot receives and in-flight sends
+		m_Ring.reset();
+	}
+
+	bool IoUring::queueSend(uint8_t socketIndex, const void* pData, uint64_t size,
+		ipv4_addr addr, uint16_t port) noexcept
+	{
+		CL_CORE_ASSERT(isActive(), "Ring must be initialized before sending");
+		CL_CORE_ASSERT(size != 0 && size <= PACKET_MTU, "Send size must be within MTU");
+
+		auto& ring{ *m_Ring };
+		// Slots are reclaimed while reaping, caller falls back to a direct send
+		if (ring.freeSends.empty()) return false;
+
+		uint16_t slot{ ring.freeSends.back() };
+		auto& op{ ring.sendOps[slot] };
+
+		std::memcpy(op.data, pData, size);
+		op.vector = { op.data, size };
+		op.to = {};
+		op.to.sin_family = AF_INET;
+		op.to.sin_addr.s_addr = htonl(addr.addr32);
+		op.to.sin_port = htons(port);
+		op.header = {};
+		op.header.msg_name = &op.to;
+		op.header.msg_namelen = sizeof(sockaddr_in);
+		op.header.msg_iov = &op.vector;
+		op.header.msg_iovlen = 1;
+
+		io_uring_sqe* sqe{ ring.getSQE() };
+		if (!sqe) return false;
+		sqe->opcode = IORING_OP_SENDMSG;
+		sqe->fd = ring.sockets[socketIndex];
+		sqe->addr = reinterpret_cast<uint64_t>(&op.header);
+		sqe->len = 1;
+		sqe->user_data = packUserData(TAG_SEND, socketIndex, slot);
+
+		ring.freeSends.pop_back();
+		return true;
+	}
+	bool IoUring::submit() noexcept
+	{
+		CL_CORE_ASSERT(isActive(), "Ring must be initialized before submitting");
+		return m_Ring->flush(IORING_ENTER_GETEVENTS);
+	}
+	bool IoUring::nextPacket(RingPacket& packet) noexcept
+	{
+		auto& ring{ *m_Ring };
+		uint32_t head{ *ring.cqHead };
+
+		while (head != loadAcquire(ring.cqTail)) {
+			io_uring_cqe cqe{ ring.cqes[head & ring.cqMask] };
+			storeRelease(ring.cqHead, ++head);
+
+			switch (getTag(cqe.user_data)) {
+			case TAG_SEND:
+				ring.freeSends.push_back(static_cast<uint16_t>(getSlot(cqe.user_data)));
+				// Never left, the caller counts it and handles what retrying won't fix
+				if (cqe.res < 0) {
+					ring.sendFailures.count++;
+					ring.sendFailures.worst = std::max(ring.sendFailures.worst, classifySend(-cqe.res));
+				}
+				break;
+
+			case TAG_RECV: {
+				uint8_t socket{ getSocket(cqe.user_data) };
+				// Multishot ended (buffer exhaustion or error), re-arm
+				if (!(cqe.flags & IORING_CQE_F_MORE)) ring.armReceive(socket);
+				if (!(cqe.flags & IORING_CQE_F_BUFFER)) break;
+
+				uint16_t bid{ static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT) };
+				if (cqe.res <= 0) {
+					ring.provideBuffer(bid);
+					break;
+				}
+				auto buffer{ ring.recvBuffers + static_cast<uint64_t>(bid) * ring.bufSize };
+				io_uring_recvmsg_out out{};
+				std::memcpy(&out, buffer, sizeof(out));
+				// Truncated datagrams are larger than MTU, never valid
+				if (out.flags & MSG_TRUNC || out.namelen < sizeof(sockaddr_in)) {
+					ring.provideBuffer(bid);
+					break;
+				}
+				sockaddr_in from{};
+				std::memcpy(&from, buffer + sizeof(out), sizeof(from));
+				uint64_t controlOffset{ sizeof(out) + ring.recvTemplates[socket].msg_namelen };
+				uint64_t payloadOffset{ controlOffset + ring.recvTemplates[socket].msg_controllen };
+
+				packet.data = { buffer + payloadOffset, out.payloadlen };
+				packet.info = { ntohl(from.sin_addr.s_addr), ntohs(from.sin_port),
+					readGROSize(buffer + controlOffset, out.controllen) };
+				packet.bufferID = bid;
+				packet.socketIndex = socket;
+				return true;
+			}
+			default:
+				break;
+			}
+		}
+		return false;
+	}
+	SendFailures IoUring::takeSendFailures() noexcept
+	{
+		return std::exchange(m_Ring->sendFailures, SendFailures{});
+	}
+	void IoUring::release(const RingPacket& packet) noexcept
+	{
+		m_Ring->provideBuffer(packet.bufferID);
+	}
+	uint64_t IoUring::getHandle() const noexcept
+	{
+		return isActive() ? static_cast<uint64_t>(m_Ring->fd) : UINT64_MAX;
+	}
+	bool IoUring::lockBuffers() noexcept
+	{
+		if (!isActive()) return false;
+		return lockMemory(m_Ring->recvBuffers, static_cast<uint64_t>(m_Ring->bufCount) * m_Ring->bufSize)
+			&& lockMemory(m_Ring->sendOps.get(), sizeof(Ring::SendOp) * SEND_SLOT_COUNT);
+	}
+}
+#else
+namespace Carnival::Network {
+	// io_uring is Linux only, every call reports an inactive ring
+	struct IoUring::Ring {};
+
+	IoUring::IoUring() noexcept {}
+	IoUring::~IoUring() noexcept {}
+	bool IoUring::init(std::span<const uint64_t>, bool) noexcept { return false; }
+	void IoUring::shutdown() noexcept {}
+	bool IoUring::queueSend(uint8_t, const void*, uint64_t, ipv4_addr, uint16_t) noexcept { return false; }
+	bool IoUring::submit() noexcept { return false; }
+	bool IoUring::nextPacket(RingPacket&) noexcept { return false; }
+	SendFailures IoUring::takeSendFailures() noexcept { return {}; }
+	void IoUring::release(const RingPacket&) noexcept {}
+	uint64_t IoUring::getHandle() const noexcept { return UINT64_MAX; }
+	bool IoUring::lockBuffers() noexcept { return false; }
+}
+#endif
@@ -0,0 +1,566 @@
+#include <src/CNMpch.hpp>
+
+#if defined(CL_Platform_Linux) || defined(CL_Platform_Mac)
+#include <include/CNM/macros.h>
+#include <include/CNM/Socket.h>
+namespace {
+	constexpr uint64_t INVALID_HANDLE{ UINT64_MAX };
+	// Upper bound of datagrams handed to a single recvmmsg / sendmmsg call
+	constexpr uint32_t MAX_BATCH{ 64 };
+
+	inline int toFD(uint64_t handle) noexcept { return static_cast<int>(handle); }
+
+	inline sockaddr_in toSockAddr(const Carnival::Network::ipv4_addr addr, uint16_t port) noexcept {
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(addr.addr32);
+		address.sin_port = htons(port);
+		return address;
+	}
+#ifdef CL_Platform_Linux
+	// Segment size of a GRO-coalesced receive, 0 if the datagram was not coalesced
+	inline uint16_t readGROSize(msghdr& msg) noexcept {
+		for (cmsghdr* c{ CMSG_FIRSTHDR(&msg) }; c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+			if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+				int size{};
+				std::memcpy(&size, CMSG_DATA(c), sizeof(size));
+				return static_cast<uint16_t>(size);
+			}
+		}
+		return 0;
+	}
+	constexpr uint32_t GRO_CONTROL_SIZE{ CMSG_SPACE(sizeof(int)) };
+#endif
+}
+
+namespace Carnival::Network {
+	// Non-Opening Constructor
+	Socket::Socket() noexcept {}
+	// Opens Socket immediately
+	Socket::Socket(const SocketData& initData) noexcept
+	{
+		// Set
+		m_Status = initData.status;
+		m_Status = static_cast<SocketStatus> (m_Status
+			& (~(SocketStatus::NONE
+			| SocketStatus::OPEN
+			| SocketStatus::ACTIVE
+			| SocketStatus::SOCKERROR)));
+
+		m_InAddress = initData.InAddress;
+		m_Port = initData.InPort;
+	}
+	Socket::~Socket() noexcept
+	{
+		if (isOpen() || isBound() || m_Handle != INVALID_HANDLE) closeSocket();
+	}
+	PollResult Socket::waitForPackets(int32_t timeout, uint64_t handle1, uint64_t handle2) noexcept
+	{
+		CL_CORE_ASSERT(handle1 != INVALID_HANDLE
+			&& handle2 != INVALID_HANDLE, "Invalid Sockets!");
+
+		pollfd fds[2]{ { toFD(handle1), POLLIN, 0 }, { toFD(handle2), POLLIN, 0 } };
+
+		int ready = ::poll(fds, 2, timeout);
+		if (ready < 0) {
+			if (errno == EINTR) return PollResult::None;
+			std::print("Socket Error: {}", errno);
+			return PollResult::Error;
+		}
+		if (fds[0].revents & POLLERR || fds[1].revents & POLLERR) return PollResult::Error;
+		if (fds[0].revents & POLLIN || fds[1].revents & POLLIN) return PollResult::Packet;
+
+		return PollResult::None;
+	}
+	uint32_t Socket::pollSockets(std::span<const uint64_t> handles, std::span<PollResult> results,
+		int64_t timeoutUs) noexcept
+	{
+		CL_CORE_ASSERT(handles.size() <= SOCKET_COUNT && results.size() >= handles.size(),
+			"Too many sockets or too few results!");
+
+		pollfd fds[SOCKET_COUNT]{};
+		for (size_t i{}; i < handles.size(); i++) fds[i] = { toFD(handles[i]), POLLIN, 0 };
+
+#ifdef CL_Platform_Linux
+		// Nanosecond timeout, poll() would round up to the next millisecond
+		const timespec ts{ timeoutUs / 1'000'000, (timeoutUs % 1'000'000) * 1000 };
+		int ready = ::ppoll(fds, static_cast<nfds_t>(handles.size()), timeoutUs < 0 ? nullptr : &ts, nullptr);
+#else
+		int ready = ::poll(fds, static_cast<nfds_t>(handles.size()),
+			timeoutUs < 0 ? -1 : static_cast<int>(timeoutUs / 1000));
+#endif
+		for (size_t i{}; i < handles.size(); i++) {
+			if (ready <= 0) results[i] = PollResult::None;
+			else if (fds[i].revents & POLLERR) results[i] = PollResult::Error;
+			else if (fds[i].revents & POLLIN) results[i] = PollResult::Packet;
+			else results[i] = PollResult::None;
+		}
+		if (ready < 0 && errno != EINTR) std::print("Socket Error: {}", errno);
+
+		return ready > 0 ? static_cast<uint32_t>(ready) : 0;
+	}
+	Socket::Socket(Socket&& other) noexcept
+		: m_Handle{ other.m_Handle },
+		m_InAddress{ other.m_InAddress },
+		m_Port{ other.m_Port },
+		m_Status{ other.m_Status }
+	{
+		other.m_Handle = INVALID_HANDLE;
+		other.m_InAddress.addr32 = 0;
+		other.m_Port = 0;
+		other.m_Status = SocketStatus::NONE;
+	}
+	Socket& Socket::operator=(Socket&& other) noexcept
+	{
+		if (this != &other) {
+			if (isOpen()) closeSocket();
+			m_Handle = other.m_Handle;
+			m_InAddress = other.m_InAddress;
+			m_Port = other.m_Port;
+			m_Status = other.m_Status;
+
+			other.m_Handle = INVALID_HANDLE;
+			other.m_InAddress.addr32 = 0;
+			other.m_Port = 0;
+			other.m_Status = SocketStatus::NONE;
+		}
+		return *this;
+	}
+
+	// Create Socket, Apply State
+	void Socket::openSocket()
+	{
+		if (m_Handle == INVALID_HANDLE) {
+			int fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+			if (fd < 0)
+			{
+				std::cerr << "Failed to Open Socket.\n";
+				m_Status = SocketStatus::SOCKERROR;
+				return;
+			}
+			m_Handle = static_cast<uint64_t>(fd);
+		}
+		m_Status = static_cast<SocketStatus>(SocketStatus::OPEN | m_Status);
+		// Enable Non-Blocking IO
+		if (m_Status & SocketStatus::NONBLOCKING) {
+			int flags = fcntl(toFD(m_Handle), F_GETFL, 0);
+			if (flags < 0 || fcntl(toFD(m_Handle), F_SETFL, flags | O_NONBLOCK) < 0)
+			{
+				std::cerr << "Failed to set Non-Blocking on Socket.\n";
+			}
+		}
+		// Allow Address reuse
+		if (m_Status & SocketStatus::REUSEADDR) {
+			int reuse = 1;
+			if (setsockopt(toFD(m_Handle), SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
+				std::cerr << "Failed to set Reuse on Socket.\n";
+			}
+		}
+		// Share port, kernel spreads flows across every socket bound to it
+		if (m_Status & SocketStatus::REUSEPORT) {
+			int reuse = 1;
+			if (setsockopt(toFD(m_Handle), SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+				std::cerr << "Failed to set ReusePort on Socket.\n";
+				m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::REUSEPORT);
+			}
+		}
+		// Enable Receive Coalescing
+		if (m_Status & SocketStatus::GRO) {
+#ifdef CL_Platform_Linux
+			int gro = 1;
+			if (setsockopt(toFD(m_Handle), IPPROTO_UDP, UDP_GRO, &gro, sizeof(gro)) < 0)
+#endif
+			{
+				m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::GRO);
+			}
+		}
+	}
+	// Free OS Resource
+	bool Socket::closeSocket() noexcept
+	{
+		CL_CORE_ASSERT(isOpen(), "Socket must be open before closing.");
+
+		if (!(m_Handle == INVALID_HANDLE) && ::close(toFD(m_Handle)) < 0) {
+			m_Status = SocketStatus::SOCKERROR;
+			return false;
+		}
+		else {
+			m_Status = static_cast<SocketStatus>(m_Status & (~SocketStatus::OPEN) & (~SocketStatus::BOUND));
+			m_Handle = INVALID_HANDLE;
+			return true;
+		}
+	}
+	// bind and query port
+	bool Socket::bindSocket()
+	{
+		CL_CORE_ASSERT(isOpen() && !isError(), "Socket Must be open before binding.");
+		if (m_Handle == INVALID_HANDLE) return false;
+
+		sockaddr_in service{ toSockAddr(m_InAddress, m_Port) };
+
+		socklen_t addrLen = sizeof(service);
+		if (bind(toFD(m_Handle), (const sockaddr*)&service, sizeof(sockaddr_in)) < 0
+			|| getsockname(toFD(m_Handle), (sockaddr*)&service, &addrLen) < 0)
+			return false;
+		// Set Socket Status, Address and Port
+		m_Status = static_cast<SocketStatus>(m_Status | SocketStatus::BOUND);
+		m_Port = ntohs(service.sin_port);
+		m_InAddress.addr32 = ntohl(service.sin_addr.s_addr);
+
+		return true;
+	}
+	// Send To Wrapper using existing memory
+	bool Socket::sendPacket(std::span<const std::byte> packet,
+		const ipv4_addr outAddr,
+		uint16_t port) noexcept
+	{
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Sending Packets.");
+		CL_CORE_ASSERT(packet.size() != 0, "Packet Size is 0");
+
+		if (m_Handle == INVALID_HANDLE) return false;
+
+		sockaddr_in address{ toSockAddr(outAddr, port == 0 ? m_Port : port) };
+
+		ssize_t sent = sendto(toFD(m_Handle), packet.data(), packet.size(),
+			0, (sockaddr*)&address, sizeof(sockaddr_in));
+		if (sent != static_cast<ssize_t>(packet.size())) return false;
+		else return true;
+	}
+	bool Socket::sendPacket(const void* pData, const uint64_t size,
+		const ipv4_addr out, const uint16_t port) noexcept
+	{
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Sending Packets.");
+		CL_CORE_ASSERT(size != 0, "Packet Size is 0");
+		CL_CORE_ASSERT(pData != nullptr, "Packet Data Poiner is null.");
+
+		if (m_Handle == INVALID_HANDLE) return false;
+
+		sockaddr_in address{ toSockAddr(out, port) };
+
+		ssize_t sent = sendto(toFD(m_Handle), pData, size,
+			0, (sockaddr*)&address, sizeof(sockaddr_in));
+		if (sent != static_cast<ssize_t>(size)) return false;
+		else return true;
+	}
+	SocketError Socket::sendSegmented(const void* pData, const uint64_t size, uint16_t segmentSize,
+		const ipv4_addr out, const uint16_t port) noexcept
+	{
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Sending Packets.");
+		CL_CORE_ASSERT(size != 0 && segmentSize != 0, "Packet and segment size must be set");
+		CL_CORE_ASSERT(pData != nullptr, "Packet Data Poiner is null.");
+
+		if (m_Handle == INVALID_HANDLE) return SocketError::Fatal;
+#ifdef CL_Platform_Linux
+		sockaddr_in address{ toSockAddr(out, port) };
+		iovec vector{ const_cast<void*>(pData), size };
+		alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))]{};
+
+		msghdr msg{};
+		msg.msg_name = &address;
+		msg.msg_namelen = sizeof(address);
+		msg.msg_iov = &vector;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+
+		cmsghdr* cmsg{ CMSG_FIRSTHDR(&msg) };
+		cmsg->cmsg_level = SOL_UDP;
+		cmsg->cmsg_type = UDP_SEGMENT;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+		std::memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+
+		ssize_t sent = sendmsg(toFD(m_Handle), &msg, 0);
+		if (sent == static_cast<ssize_t>(size)) return SocketError::None;
+		if (sent >= 0) return SocketError::Transient;
+
+		switch (errno) {
+		case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+		case EWOULDBLOCK:
+#endif
+		case EINTR:
+		case ENOBUFS:
+		case EMSGSIZE: // this batch exceeds a limit of the route, others may still fit
+			return SocketError::Transient;
+		case ECONNREFUSED:
+		case EHOSTUNREACH:
+		case ENETUNREACH:
+			return SocketError::Remote;
+		default: // EIO / EINVAL / ENOPROTOOPT: no GSO on this path
+			return SocketError::Fatal;
+		}
+#else
+		return SocketError::Fatal;
+#endif
+	}
+	// Non-blocking Poll
+	PollResult Socket::poll() const noexcept {
+		pollfd pfd{};
+		pfd.fd = toFD(m_Handle);
+		pfd.events = POLLIN;
+		int ready = ::poll(&pfd, 1, 0);
+
+		if (ready <= 0) return PollResult::None;
+		if (pfd.revents & POLLERR) return PollResult::Error;
+		if (pfd.revents & POLLIN) return PollResult::Packet;
+
+		return PollResult::None;
+	}
+	PacketInfo Socket::receivePacket(std::vector<std::byte>& packet) noexcept
+	{
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Receiving Packets.");
+		CL_CORE_ASSERT(m_Handle != INVALID_HANDLE, "Socket must be open and bound before receiving packets.");
+
+		sockaddr_in from{};
+		socklen_t fromLength = sizeof(from);
+
+#ifdef CL_Platform_Linux
+		if (isGRO()) {
+			alignas(cmsghdr) char control[GRO_CONTROL_SIZE]{};
+			packet.resize(GRO_MAX_SIZE);
+			iovec vector{ packet.data(), packet.size() };
+			msghdr msg{};
+			msg.msg_name = &from;
+			msg.msg_namelen = fromLength;
+			msg.msg_iov = &vector;
+			msg.msg_iovlen = 1;
+			msg.msg_control = control;
+			msg.msg_controllen = sizeof(control);
+
+			ssize_t bytes = recvmsg(toFD(m_Handle), &msg, 0);
+			if (bytes >= 0) {
+				packet.resize(bytes);
+				return { ntohl(from.sin_addr.s_addr), ntohs(from.sin_port), readGROSize(msg) };
+			}
+		}
+		else
+#endif
+		{
+			packet.resize(PACKET_MTU);
+			ssize_t bytes = recvfrom(toFD(m_Handle), packet.data(),
+				PACKET_MTU, 0, (sockaddr*)&from, &fromLength);
+			if (bytes >= 0) { // if no errors
+				packet.resize(bytes);
+				return { ntohl(from.sin_addr.s_addr), ntohs(from.sin_port) };
+			}
+		}
+
+		// if error
+		switch (errno) {
+		case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+		case EWOULDBLOCK:
+#endif
+		case EINTR:
+			packet.clear();
+			return {};
+			break;
+
+		case ECONNREFUSED:
+		case ECONNRESET:
+		case ETIMEDOUT:
+			packet.clear();
+			break;
+		default:
+			m_Status = SocketStatus::SOCKERROR;
+			std::print("Sockerror: {}\n", errno);
+			CL_CORE_ASSERT(false, "Socket Error!");
+		}
+
+		return {};
+	}
+	// Receive as many datagrams as are queued, up to slots.size()
+	uint32_t Socket::receiveBatch(std::span<ReceiveSlot> slots) noexcept
+	{
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Receiving Packets.");
+		if (m_Handle == INVALID_HANDLE) return 0;
+
+		uint32_t received{};
+#ifdef CL_Platform_Linux
+		mmsghdr		headers[MAX_BATCH]{};
+		iovec		vectors[MAX_BATCH]{};
+		sockaddr_in	from[MAX_BATCH]{};
+		alignas(cmsghdr) char control[MAX_BATCH][GRO_CONTROL_SIZE];
+		const bool gro{ isGRO() };
+
+		while (received < slots.size()) {
+			uint32_t count{ std::min<uint32_t>(MAX_BATCH, static_cast<uint32_t>(slots.size()) - received) };
+			for (uint32_t i{}; i < count; i++) {
+				auto& slot{ slots[received + i] };
+				vectors[i] = { slot.data, slot.capacity };
+				headers[i].msg_hdr = msghdr{};
+				headers[i].msg_hdr.msg_name = &from[i];
+				headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+				headers[i].msg_hdr.msg_iov = &vectors[i];
+				headers[i].msg_hdr.msg_iovlen = 1;
+				if (gro) {
+					headers[i].msg_hdr.msg_control = control[i];
+					headers[i].msg_hdr.msg_controllen = GRO_CONTROL_SIZE;
+				}
+			}
+
+			int ret = recvmmsg(toFD(m_Handle), headers, count, MSG_DONTWAIT, nullptr);
+			if (ret < 0) {
+				// Pending ICMP error consumed, datagrams may still be queued behind it
+				if (errno == ECONNREFUSED || errno == EINTR) continue;
+				if (errno != EAGAIN && errno != EWOULDBLOCK) {
+					m_Status = SocketStatus::SOCKERROR;
+					std::print("Sockerror: {}\n", errno);
+				}
+				break;
+			}
+			for (int i{}; i < ret; i++) {
+				auto& slot{ slots[received + i] };
+				slot.size = headers[i].msg_len;
+				slot.info = { ntohl(from[i].sin_addr.s_addr), ntohs(from[i].sin_port),
+					gro ? readGROSize(headers[i].msg_hdr) : uint16_t{} };
+			}
+			received += static_cast<uint32_t>(ret);
+			// Queue drained
+			if (static_cast<uint32_t>(ret) < count) break;
+		}
+#else
+		while (received < slots.size()) {
+			auto& slot{ slots[received] };
+			sockaddr_in from{};
+			socklen_t fromLength = sizeof(from);
+
+			ssize_t bytes = recvfrom(toFD(m_Handle), slot.data, slot.capacity,
+				MSG_DONTWAIT, (sockaddr*)&from, &fromLength);
+			if (bytes < 0) {
+				if (errno == ECONNREFUSED || errno == EINTR) continue;
+				break;
+			}
+			slot.size = static_cast<uint32_t>(bytes);
+			slot.info = { ntohl(from.sin_addr.s_addr), ntohs(from.sin_port) };
+			received++;
+		}
+#endif
+		return received;
+	}
+	// Send every datagram in packets, stops early if the send buffer is full
+	uint32_t Socket::sendBatch(std::span<const SendSlot> packets) noexcept
+	{
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Sending Packets.");
+		if (m_Handle == INVALID_HANDLE) return 0;
+
+		uint32_t sent{};
+#ifdef CL_Platform_Linux
+		mmsghdr		headers[MAX_BATCH]{};
+		iovec		vectors[MAX_BATCH]{};
+		sockaddr_in	to[MAX_BATCH]{};
+
+		while (sent < packets.size()) {
+			uint32_t count{ std::min<uint32_t>(MAX_BATCH, static_cast<uint32_t>(packets.size()) - sent) };
+			for (uint32_t i{}; i < count; i++) {
+				auto& packet{ packets[sent + i] };
+				CL_CORE_ASSERT(packet.data && packet.size, "Packet must have data and size");
+				to[i] = toSockAddr(packet.addr, packet.port);
+				vectors[i] = { const_cast<std::byte*>(packet.data), packet.size };
+				headers[i].msg_hdr = msghdr{};
+				headers[i].msg_hdr.msg_name = &to[i];
+				headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+				headers[i].msg_hdr.msg_iov = &vectors[i];
+				headers[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			int ret = sendmmsg(toFD(m_Handle), headers, count, 0);
+			if (ret < 0) {
+				if (errno == EINTR) continue;
+				// Peer unreachable errors apply to one datagram, skip it
+				if (errno == ECONNREFUSED) { sent++; continue; }
+				break;
+			}
+			sent += static_cast<uint32_t>(ret);
+			if (static_cast<uint32_t>(ret) < count) break;
+		}
+#else
+		for (auto& packet : packets) {
+			if (!sendPacket(packet.data, packet.size, packet.addr, packet.port)) break;
+			sent++;
+		}
+#endif
+		return sent;
+	}
+	// Read and clear the pending socket error without consuming queued datagrams
+	SocketError Socket::pollError() noexcept
+	{
+		int err{};
+		socklen_t errLen = sizeof(err);
+		if (getsockopt(toFD(m_Handle), SOL_SOCKET, SO_ERROR, &err, &errLen) < 0)
+			return SocketError::Fatal;
+
+		switch (err) {
+		case 0:
+			return SocketError::None;
+		case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+		case EWOULDBLOCK:
+#endif
+		case EINTR:
+			return SocketError::Transient;
+			break;
+
+		case ECONNREFUSED:
+		case EHOSTUNREACH:
+		case ENETUNREACH:
+		case ETIMEDOUT:
+			return SocketError::Remote;
+			break;
+		default:
+			return SocketError::Fatal;
+		}
+	}
+
+	void Socket::setNonBlocking(bool nb) {
+		if (nb) m_Status = static_cast<SocketStatus>(m_Status | SocketStatus::NONBLOCKING);
+		else m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::NONBLOCKING);
+
+		// Toggled on the open descriptor, no rebind
+		if (m_Handle == INVALID_HANDLE) return;
+		int flags = fcntl(toFD(m_Handle), F_GETFL, 0);
+		if (flags < 0 || fcntl(toFD(m_Handle), F_SETFL, nb ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) < 0)
+		{
+			std::cerr << "Failed to set Non-Blocking on Socket.\n";
+		}
+	}
+	void Socket::setGRO(bool gro) {
+		if (gro) m_Status = static_cast<SocketStatus>(m_Status | SocketStatus::GRO);
+		else m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::GRO);
+
+		if (isBound() && m_Handle != INVALID_HANDLE) {
+			closeSocket();
+			openSocket();
+			bindSocket();
+		}
+	}
+	void Socket::setReusePort(bool reuse) {
+		if (reuse) m_Status = static_cast<SocketStatus>(m_Status | SocketStatus::REUSEPORT);
+		else m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::REUSEPORT);
+
+		if (isBound() && m_Handle != INVALID_HANDLE) {
+			closeSocket();
+			openSocket();
+			bindSocket();
+		}
+	}
+	void Socket::setInAddress(ipv4_addr inAddr)
+	{
+		m_InAddress = inAddr;
+		if (isBound() && m_Handle != INVALID_HANDLE) {
+			closeSocket();
+			openSocket();
+			bindSocket();
+		}
+	}
+	void Socket::setPort(uint16_t port)
+	{
+		m_Port = port;
+		if (isBound() && m_Handle != INVALID_HANDLE) {
+			closeSocket();
+			openSocket();
+			bindSocket();
+		}
+	}
+}
+#endif
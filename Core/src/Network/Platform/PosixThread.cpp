@@ -0,0 +1,57 @@
+#include <src/CNMpch.hpp>
+
+#if defined(CL_Platform_Linux) || defined(CL_Platform_Mac)
+#include <include/CNM/ThreadConfig.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+namespace Carnival::Network {
+	ThreadConfigStatus applyThreadConfig(const ThreadConfig& config) noexcept
+	{
+		ThreadConfigStatus status{};
+
+		if (config.affinityMask) {
+#ifdef CL_Platform_Linux
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			for (uint32_t cpu{}; cpu < 64; cpu++)
+				if (config.affinityMask & (1ull << cpu)) CPU_SET(cpu, &set);
+			status.affinity = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0
+				? SettingState::Applied : SettingState::Failed;
+#else
+			// Affinity tags are only hints on macOS
+			status.affinity = SettingState::Failed;
+#endif
+		}
+
+		if (config.realtime) {
+			sched_param param{};
+			param.sched_priority = std::clamp(config.priority,
+				sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+			status.scheduling = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0
+				? SettingState::Applied : SettingState::Failed;
+		}
+		else if (config.nice) {
+#ifdef CL_Platform_Linux
+			// Linux niceness is per thread
+			status.scheduling = setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), config.nice) == 0
+				? SettingState::Applied : SettingState::Failed;
+#else
+			// macOS niceness is per process, would slow the simulation thread too
+			status.scheduling = SettingState::Failed;
+#endif
+		}
+
+		return status;
+	}
+
+	bool lockMemory(const void* pData, uint64_t size) noexcept
+	{
+		if (!pData || !size) return true;
+		return mlock(pData, size) == 0;
+	}
+}
+#endif
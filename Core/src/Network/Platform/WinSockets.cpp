@@ -66,6 +66,34 @@ namespace Carnival::Network {
 
 		return PollResult::None;
 	}
+	uint32_t Socket::pollSockets(std::span<const uint64_t> handles, std::span<PollResult> results,
+		int64_t timeoutUs) noexcept
+	{
+		CL_CORE_ASSERT(handles.size() <= SOCKET_COUNT && results.size() >= handles.size(),
+			"Too many sockets or too few results!");
+
+		// Millisecond granularity, rounds down so callers wake early rather than late
+		const int timeout{ timeoutUs < 0 ? -1 : static_cast<int>(timeoutUs / 1000) };
+		if (handles.empty()) {
+			// WSAPoll rejects an empty set
+			if (timeout) Sleep(static_cast<DWORD>(timeout));
+			return 0;
+		}
+
+		WSAPOLLFD fds[SOCKET_COUNT]{};
+		for (size_t i{}; i < handles.size(); i++) fds[i] = { handles[i], POLLRDNORM, 0 };
+
+		int ready = WSAPoll(fds, static_cast<ULONG>(handles.size()), timeout);
+		for (size_t i{}; i < handles.size(); i++) {
+			if (ready <= 0) results[i] = PollResult::None;
+			else if (fds[i].revents & POLLERR) results[i] = PollResult::Error;
+			else if (fds[i].revents & POLLRDNORM) results[i] = PollResult::Packet;
+			else results[i] = PollResult::None;
+		}
+		if (ready == SOCKET_ERROR) std::print("Socket Error: {}", WSAGetLastError());
+
+		return ready > 0 ? static_cast<uint32_t>(ready) : 0;
+	}
 	Socket::Socket(Socket&& other) noexcept
 		: m_Handle{ other.m_Handle },
 		m_InAddress{ other.m_InAddress },
@@ -124,6 +152,10 @@ namespace Carnival::Network {
 				std::cerr << "Failed to set Reuse on Socket.\n";
 			}
 		}
+		// Receive coalescing needs WSARecvMsg, not supported by this backend
+		m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::GRO);
+		// WinSock has no load-balanced port sharing
+		m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::REUSEPORT);
 	}
 	// Free OS Resource
 	bool Socket::closeSocket() noexcept
@@ -216,6 +248,12 @@ namespace Carnival::Network {
 		if (sent != size) return false;
 		else return true;
 	}
+	// UDP send offload needs WSASendMsg, callers fall back to single datagrams
+	SocketError Socket::sendSegmented(const void* pData, const uint64_t size, uint16_t segmentSize,
+		const ipv4_addr out, const uint16_t port) noexcept
+	{
+		return SocketError::Fatal;
+	}
 	// Non-blocking Poll
 	PollResult Socket::poll() const noexcept {
 		WSAPOLLFD pfd{};
@@ -270,6 +308,45 @@ namespace Carnival::Network {
 
 		return {};
 	}
+	// WinSock has no multi-message receive, drain with recvfrom up to slots.size()
+	uint32_t Socket::receiveBatch(std::span<ReceiveSlot> slots) noexcept
+	{
+		CL_CORE_ASSERT(winsockState == WSAState::INITIALIZED, "WSA uninitialized");
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Receiving Packets.");
+		if (m_Handle == INVALID_SOCKET) return 0;
+
+		uint32_t received{};
+		while (received < slots.size()) {
+			auto& slot{ slots[received] };
+			sockaddr_in from{};
+			int fromLength = sizeof(from);
+
+			int bytes = recvfrom(m_Handle, reinterpret_cast<char*>(slot.data),
+				static_cast<int>(slot.capacity), 0, (sockaddr*)&from, &fromLength);
+			if (bytes == SOCKET_ERROR) {
+				// ICMP errors are reported per datagram, keep draining
+				int err{ WSAGetLastError() };
+				if (err == WSAECONNRESET || err == WSAEINTR) continue;
+				break;
+			}
+			slot.size = static_cast<uint32_t>(bytes);
+			slot.info = { ntohl(from.sin_addr.s_addr), ntohs(from.sin_port) };
+			received++;
+		}
+		return received;
+	}
+	uint32_t Socket::sendBatch(std::span<const SendSlot> packets) noexcept
+	{
+		CL_CORE_ASSERT(winsockState == WSAState::INITIALIZED, "WSA uninitialized");
+		CL_CORE_ASSERT(isBound() && !isError(), "Socket Must be Bound before Sending Packets.");
+
+		uint32_t sent{};
+		for (auto& packet : packets) {
+			if (!sendPacket(packet.data, packet.size, packet.addr, packet.port)) break;
+			sent++;
+		}
+		return sent;
+	}
 	// Probe socket error
 	SocketError Socket::pollError() noexcept
 	{
@@ -315,6 +392,28 @@ namespace Carnival::Network {
 			bindSocket();
 		}
 	}
+	void Socket::setGRO(bool gro) {
+		CL_CORE_ASSERT(winsockState == WSAState::INITIALIZED, "WSA uninitialized");
+		if (gro) m_Status = static_cast<SocketStatus>(m_Status | SocketStatus::GRO);
+		else m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::GRO);
+
+		if (isBound() && m_Handle != INVALID_SOCKET) {
+			closeSocket();
+			openSocket();
+			bindSocket();
+		}
+	}
+	void Socket::setReusePort(bool reuse) {
+		CL_CORE_ASSERT(winsockState == WSAState::INITIALIZED, "WSA uninitialized");
+		if (reuse) m_Status = static_cast<SocketStatus>(m_Status | SocketStatus::REUSEPORT);
+		else m_Status = static_cast<SocketStatus>(m_Status & ~SocketStatus::REUSEPORT);
+
+		if (isBound() && m_Handle != INVALID_SOCKET) {
+			closeSocket();
+			openSocket();
+			bindSocket();
+		}
+	}
 	void Socket::setInAddress(ipv4_addr inAddr)
 	{
 		CL_CORE_ASSERT(winsockState == WSAState::INITIALIZED, "WSA uninitialized");
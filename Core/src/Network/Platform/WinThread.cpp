@@ -0,0 +1,39 @@
+#include <src/CNMpch.hpp>
+
+#ifdef CL_Platform_Windows
+#include <include/CNM/ThreadConfig.h>
+
+namespace Carnival::Network {
+	ThreadConfigStatus applyThreadConfig(const ThreadConfig& config) noexcept
+	{
+		ThreadConfigStatus status{};
+		HANDLE thread{ GetCurrentThread() };
+
+		if (config.affinityMask) {
+			status.affinity = SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(config.affinityMask)) != 0
+				? SettingState::Applied : SettingState::Failed;
+		}
+
+		if (config.realtime || config.nice) {
+			// No per-thread niceness, map onto the thread priority levels
+			int priority{ THREAD_PRIORITY_NORMAL };
+			if (config.realtime) priority = THREAD_PRIORITY_TIME_CRITICAL;
+			else if (config.nice <= -10) priority = THREAD_PRIORITY_HIGHEST;
+			else if (config.nice < 0) priority = THREAD_PRIORITY_ABOVE_NORMAL;
+			else if (config.nice >= 10) priority = THREAD_PRIORITY_LOWEST;
+			else priority = THREAD_PRIORITY_BELOW_NORMAL;
+			status.scheduling = SetThreadPriority(thread, priority)
+				? SettingState::Applied : SettingState::Failed;
+		}
+
+		return status;
+	}
+
+	bool lockMemory(const void* pData, uint64_t size) noexcept
+	{
+		if (!pData || !size) return true;
+		// Bounded by the working set minimum, fails once that is exhausted
+		return VirtualLock(const_cast<void*>(pData), static_cast<SIZE_T>(size)) != 0;
+	}
+}
+#endif
@@ -45,6 +45,10 @@ project "ServerApp"
 		{
 			"CL_Platform_Linux"
 		}
+		links
+		{
+			"pthread",
+		}
 	filter "system:macosx"
 		defines
 		{
@@ -0,0 +1,28 @@
+project "Tests"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++23"
+	
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/bin-int/" .. outputdir .. "/%{prj.name}")
+	
+	files
+	{
+		"src/**.h",
+		"src/**.cpp"
+	}
+	
+	includedirs
+	{
+		"%{wks.location}/Core/include",
+	}
+	
+	-- Header-only code under test, asserts on in every configuration
+	defines
+	{
+		"CL_ENABLE_ASSERTS"
+	}
+	
+	filter "configurations:Debug"
+		symbols "Full"
+		optimize "Off"
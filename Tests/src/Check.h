@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <print>
+
+namespace Carnival::Tests {
+
+	// Failures across every suite, main's exit code
+	inline uint32_t g_Failures{};
+
+	inline void check(bool passed, const char* expression, const char* file, int line) {
+		if (passed) return;
+		g_Failures++;
+		std::print("{}:{}: CHECK({}) failed\n", file, line, expression);
+	}
+
+	// Suites, one per translation unit
+	void flatIndexTests();
+	void timerWheelTests();
+}
+
+#define CHECK(x) ::Carnival::Tests::check(static_cast<bool>(x), #x, __FILE__, __LINE__)
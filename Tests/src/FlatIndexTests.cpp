@@ -0,0 +1,99 @@
+#include "Check.h"
+
+#include <CNM/SessionTable.h>
+
+#include <array>
+#include <random>
+#include <unordered_map>
+
+using namespace Carnival::Network;
+
+namespace {
+	// Keys home on their own low bits, tests place them on chosen slots
+	struct IdentityMix {
+		uint32_t operator()(uint32_t key) const noexcept { return key; }
+	};
+	using Index = FlatIndex<uint32_t, IdentityMix>;
+	constexpr uint32_t NONE{ Index::NONE };
+
+	// A probe run starting in the last slot wraps to the front, erasing from it must pull
+	// the wrapped entries back across the end without stranding a later run
+	void eraseAcrossWrap() {
+		Index index{ 16 };
+		constexpr std::array<uint32_t, 3> tail{ 15, 31, 47 }; // homed at 15, stored in 15, 0, 1
+		constexpr uint32_t front{ 16 }; // homed at 0, displaced to slot 2
+		for (uint32_t i{}; i < tail.size(); i++) index.assign(tail[i], i);
+		index.assign(front, 10);
+		CHECK(index.size() == 4);
+
+		index.erase(tail[0]);
+		CHECK(index.find(tail[0]) == NONE);
+		CHECK(index.find(tail[1]) == 1);
+		CHECK(index.find(tail[2]) == 2);
+		CHECK(index.find(front) == 10);
+
+		// Middle of the wrapped run
+		index.erase(tail[2]);
+		CHECK(index.find(tail[1]) == 1);
+		CHECK(index.find(front) == 10);
+
+		index.erase(tail[1]);
+		index.erase(front);
+		CHECK(index.size() == 0);
+		CHECK(index.find(front) == NONE);
+	}
+
+	// Entry homed past the hole but stored before the end stays put
+	void eraseKeepsEntryHomedPastHole() {
+		Index index{ 16 };
+		index.assign(14, 1); // slot 14
+		index.assign(15, 2); // slot 15, at home
+		index.assign(30, 3); // homed at 14, slot 0
+		index.assign(46, 4); // homed at 14, slot 1
+
+		index.erase(15);
+		CHECK(index.find(14) == 1);
+		CHECK(index.find(15) == NONE);
+		CHECK(index.find(30) == 3);
+		CHECK(index.find(46) == 4);
+
+		index.erase(14);
+		CHECK(index.find(30) == 3);
+		CHECK(index.find(46) == 4);
+		CHECK(index.size() == 2);
+	}
+
+	// Random assign and erase against a reference map, through several rehashes
+	void churnMatchesReference() {
+		FlatIndex<uint32_t> index{};
+		std::unordered_map<uint32_t, uint32_t> reference;
+		std::mt19937 rng{ 7 };
+		std::uniform_int_distribution<uint32_t> keys{ 1, 512 };
+		for (uint32_t step{}; step < 20'000; step++) {
+			const uint32_t key{ keys(rng) };
+			if (rng() % 3) {
+				index.assign(key, step);
+				reference[key] = step;
+			}
+			else {
+				index.erase(key);
+				reference.erase(key);
+			}
+			if (step % 1'000) continue;
+			CHECK(index.size() == reference.size());
+			for (uint32_t probe{ 1 }; probe <= 512; probe++) {
+				const auto it{ reference.find(probe) };
+				CHECK(index.find(probe) == (it == reference.end() ? NONE : it->second));
+			}
+		}
+	}
+}
+
+namespace Carnival::Tests {
+	void flatIndexTests()
+	{
+		eraseAcrossWrap();
+		eraseKeepsEntryHomedPastHole();
+		churnMatchesReference();
+	}
+}
@@ -0,0 +1,12 @@
+#include "Check.h"
+
+int main()
+{
+	using namespace Carnival::Tests;
+	flatIndexTests();
+	timerWheelTests();
+
+	if (g_Failures) std::print("{} checks failed\n", g_Failures);
+	else std::print("All checks passed\n");
+	return g_Failures ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+#include "Check.h"
+
+#include <CNM/TimerWheel.h>
+
+#include <array>
+
+using namespace Carnival::Network;
+
+namespace {
+	using Wheel = TimerWheel<uint32_t>;
+	constexpr uint64_t SLOT{ 1ull << Wheel::RESOLUTION_SHIFT };
+	constexpr uint64_t LEVEL1{ Wheel::SLOTS }; // 64 slots, first cascade
+	constexpr uint64_t LEVEL2{ LEVEL1 * Wheel::SLOTS }; // 4096
+	constexpr uint64_t REACH{ 1ull << (Wheel::SLOT_BITS * Wheel::LEVELS) }; // slots the outermost level spans
+
+	// Slot a timer fires on when the wheel advances one slot at a time, 0 if not by limit
+	uint64_t firingSlot(uint64_t startSlot, uint64_t deadline, uint64_t limitSlot) {
+		Wheel wheel{ startSlot * SLOT };
+		wheel.schedule(deadline, 1);
+		for (uint64_t slot{ startSlot + 1 }; slot <= limitSlot; slot++) {
+			bool fired{ false };
+			wheel.advance(slot * SLOT, [&](uint32_t) { fired = true; });
+			if (fired) return slot;
+		}
+		return 0;
+	}
+
+	// Exactly on its slot whichever level it was parked in, across the 64 and 4096 laps
+	void firesOnTimeAcrossCascades() {
+		constexpr std::array<uint64_t, 5> starts{ 0, 1, LEVEL1 - 1, LEVEL2 - 100, LEVEL2 * Wheel::SLOTS - 3 };
+		constexpr std::array<uint64_t, 12> deltas{ 1, 2, LEVEL1 - 1, LEVEL1, LEVEL1 + 1, 2 * LEVEL1 + 5,
+			LEVEL2 - 1, LEVEL2, LEVEL2 + 1, LEVEL2 + 3 * LEVEL1 + 7, 2 * LEVEL2 - 1, 2 * LEVEL2 + 1 };
+		for (uint64_t start : starts) {
+			for (uint64_t delta : deltas) {
+				const uint64_t target{ start + delta };
+				CHECK(firingSlot(start, target * SLOT, target + 1) == target);
+			}
+		}
+	}
+
+	// Deadlines between slots round up, never firing before they are due
+	void roundsUp() {
+		CHECK(firingSlot(0, 10 * SLOT + 1, 20) == 11);
+		CHECK(firingSlot(0, 10 * SLOT - 1, 20) == 10);
+		// Already due, the next slot
+		CHECK(firingSlot(5, 0, 20) == 6);
+	}
+
+	// Advancing many slots in one call still fires everything due, once
+	void advanceSkipsAhead() {
+		Wheel wheel{};
+		for (uint32_t i{ 1 }; i <= 100; i++) wheel.schedule(static_cast<uint64_t>(i) * 97 * SLOT, i);
+		CHECK(wheel.size() == 100);
+		uint32_t fired{};
+		uint64_t sum{};
+		wheel.advance(50 * 97 * SLOT, [&](uint32_t value) { fired++; sum += value; });
+		CHECK(fired == 50);
+		CHECK(sum == 50 * 51 / 2);
+		CHECK(wheel.size() == 50);
+		wheel.advance(100 * 97 * SLOT, [&](uint32_t) { fired++; });
+		CHECK(fired == 100);
+		CHECK(wheel.size() == 0);
+	}
+
+	// Past the outermost level a timer parks at the edge of reach and fires early, re-arming lands it on time
+	void clampsBeyondReach() {
+		const uint64_t target{ REACH + 5'000 };
+		Wheel wheel{};
+		wheel.schedule(target * SLOT, 1);
+		uint64_t firstFire{};
+		uint64_t lastFire{};
+		for (uint64_t slot{ 1 }; slot <= target + 1 && !lastFire; slot++) {
+			wheel.advance(slot * SLOT, [&](uint32_t) {
+				if (!firstFire) firstFire = slot;
+				if (slot < target) wheel.schedule(target * SLOT, 1);
+				else lastFire = slot;
+			});
+		}
+		CHECK(firstFire != 0);
+		// Early, but within the outermost level's last slot of the wheel's reach
+		CHECK(firstFire < REACH);
+		CHECK(firstFire >= REACH - LEVEL2 * Wheel::SLOTS);
+		CHECK(lastFire == target);
+		CHECK(wheel.size() == 0);
+	}
+}
+
+namespace Carnival::Tests {
+	void timerWheelTests()
+	{
+		firesOnTimeAcrossCascades();
+		roundsUp();
+		advanceSkipsAhead();
+		clampsBeyondReach();
+	}
+}
@@ -24,3 +24,7 @@ group "App"
 	include "ClientApp"
 group ""
 
+group "Tests"
+	include "Tests"
+group ""
+